@@ -0,0 +1,95 @@
+//
+//  FFTBackendAuto.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+#include "FFTPlanner.h"
+
+/// The fastest backend of its track for each length, chosen by FFTPlanner (see
+/// FFTPlanner.h); every call goes to that backend, so the layout is its layout.
+/// Opt-in: the first setup of a length times every other backend of the track.
+class FFTBackendAuto : public FFTBackend {
+public:
+    FFTBackendAuto(FFTTransform transform, FFTPrecision precision)
+        : _transform(transform), _precision(precision), _impl(NULL) {}
+
+    bool supports(int length) const {
+        const std::vector<FFTBackendInfo> &all = FFTBackendRegistry::backends();
+        for (size_t i = 0; i < all.size(); i++) {
+            const FFTBackendInfo &info = all[i];
+            if (info.transform != _transform || info.precision != _precision || info.optIn) continue;
+            FFTBackend *probe = info.create();
+            bool supported = probe->supports(length);
+            delete probe;
+            if (supported) return true;
+        }
+        return false;
+    }
+
+    bool setup(int length) {
+        const FFTBackendInfo *info = NULL;
+        {
+            FFTPlanScope plan; // the search, its candidates' setups included, is the plan of auto
+            info = FFTPlannerChoose(length, _transform, _precision);
+        }
+        if (!info) return false;
+        _impl = info->create();
+        return _impl->setup(length);
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        FFTBackendAuto *plan = static_cast<FFTBackendAuto *>(owner);
+        if (!plan->_impl) return false;
+        const FFTBackendInfo *info = FFTPlannerChoose(length, _transform, _precision);
+        if (!info) return false;
+        _impl = info->create();
+        return _impl->setupShared(plan->_impl, length);
+    }
+
+    void forward() { _impl->forward(); }
+    void inverse() { _impl->inverse(); }
+
+    void teardown() {
+        if (_impl) {
+            _impl->teardown();
+            delete _impl;
+        }
+        _impl = NULL;
+    }
+
+    FFTLayout layout() const { return _impl->layout(); }
+
+    bool isReentrant() const { return _impl ? _impl->isReentrant() : true; }
+
+    bool relocate(int length, const FFTPlacement &placement) { return _impl->relocate(length, placement); }
+
+private:
+    FFTTransform _transform;
+    FFTPrecision _precision;
+    FFTBackend *_impl;
+};
+
+static FFTBackend *FFTBackendAuto_create(void) {
+    return new FFTBackendAuto(FFTTransformComplex, FFTPrecisionFloat);
+}
+static FFTBackend *FFTBackendAuto_createReal(void) {
+    return new FFTBackendAuto(FFTTransformReal, FFTPrecisionFloat);
+}
+static FFTBackend *FFTBackendAuto_createDouble(void) {
+    return new FFTBackendAuto(FFTTransformComplex, FFTPrecisionDouble);
+}
+static FFTBackend *FFTBackendAuto_createDoubleReal(void) {
+    return new FFTBackendAuto(FFTTransformReal, FFTPrecisionDouble);
+}
+
+static FFTBackendRegistrar FFTBackendAuto_registrar("auto", 95, FFTTransformComplex, FFTPrecisionFloat,
+                                                    FFTBackendAuto_create, true);
+static FFTBackendRegistrar FFTBackendAuto_registrarReal("auto-r", 95, FFTTransformReal, FFTPrecisionFloat,
+                                                        FFTBackendAuto_createReal, true);
+static FFTBackendRegistrar FFTBackendAuto_registrarDouble("auto-d", 95, FFTTransformComplex, FFTPrecisionDouble,
+                                                          FFTBackendAuto_createDouble, true);
+static FFTBackendRegistrar FFTBackendAuto_registrarDoubleReal("auto-r-d", 95, FFTTransformReal, FFTPrecisionDouble,
+                                                              FFTBackendAuto_createDoubleReal, true);
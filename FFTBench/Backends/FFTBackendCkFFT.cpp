@@ -0,0 +1,170 @@
+//
+//  FFTBackendCkFFT.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+#include "ckfft.h"
+
+#include <stdlib.h>
+
+/// ckfft: out-of-place, interleaved float, one context for both directions.
+class FFTBackendCkFFT : public FFTBackend {
+public:
+    FFTBackendCkFFT() : _length(0), _context(NULL), _shared(false), _in(NULL), _out(NULL) {}
+
+    bool supports(int length) const { return FFTSizeIsPow2(length) && length >= 2; }
+
+    bool setup(int length) {
+        _length = length;
+        {
+            FFTPlanScope plan;
+            _context = CkFftInit(length, kCkFftDirection_Both, NULL, NULL);
+        }
+        _in = (CkFftComplex *)calloc(length, sizeof(CkFftComplex));
+        _out = (CkFftComplex *)calloc(length, sizeof(CkFftComplex));
+        return _context && _in && _out;
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        _length = length;
+        _context = static_cast<FFTBackendCkFFT *>(owner)->_context; // stateless, shareable by design
+        _shared = true;
+        _in = (CkFftComplex *)calloc(length, sizeof(CkFftComplex));
+        _out = (CkFftComplex *)calloc(length, sizeof(CkFftComplex));
+        return _context && _in && _out;
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) { // unaligned NEON loads, scalar elsewhere
+        bool own = _placed.isEmpty();
+        size_t bytes = sizeof(CkFftComplex) * length;
+        CkFftComplex *in = (CkFftComplex *)_placed.alloc(bytes, placement.offset);
+        CkFftComplex *out = (CkFftComplex *)_placed.alloc(bytes, FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        if (own) {
+            free(_in);
+            free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { CkFftComplexForward(_context, _length, _in, _out); }
+    void inverse() { CkFftComplexInverse(_context, _length, _out, _in); }
+
+    void teardown() {
+        if (_context && !_shared) CkFftShutdown(_context);
+        if (_placed.isEmpty()) {
+            free(_in);
+            free(_out);
+        }
+        _placed.release();
+        _context = NULL;
+        _in = _out = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {&_in->real, &_in->imag, 2};
+        FFTBuffer out = {&_out->real, &_out->imag, 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        return layout;
+    }
+
+private:
+    int _length;
+    CkFftContext *_context;
+    bool _shared;
+    CkFftComplex *_in;
+    CkFftComplex *_out;
+    FFTPlacementBuffers _placed;
+};
+
+FFT_REGISTER_BACKEND("ckfft", 60, FFTBackendCkFFT);
+
+
+/// ckfft real: real float input, N/2+1 interleaved bins scaled by 2. The inverse needs a scratch buffer.
+class FFTBackendCkFFTReal : public FFTBackend {
+public:
+    FFTBackendCkFFTReal() : _length(0), _context(NULL), _shared(false), _in(NULL), _out(NULL), _tmp(NULL) {}
+
+    bool supports(int length) const { return FFTSizeIsPow2(length) && length >= 4; }
+
+    bool setup(int length) {
+        _length = length;
+        {
+            FFTPlanScope plan;
+            _context = CkFftInit(length, kCkFftDirection_Both, NULL, NULL);
+        }
+        return _context && allocBuffers(length);
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        _length = length;
+        _context = static_cast<FFTBackendCkFFTReal *>(owner)->_context;
+        _shared = true;
+        return _context && allocBuffers(length);
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        bool own = _placed.isEmpty();
+        float *in = (float *)_placed.alloc(sizeof(float) * length, placement.offset);
+        CkFftComplex *out = (CkFftComplex *)_placed.alloc(sizeof(CkFftComplex) * (length / 2 + 1),
+                                                          FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        if (own) {
+            free(_in);
+            free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { CkFftRealForward(_context, _length, _in, _out); }
+    void inverse() { CkFftRealInverse(_context, _length, _out, _in, _tmp); }
+
+    void teardown() {
+        if (_context && !_shared) CkFftShutdown(_context);
+        if (_placed.isEmpty()) {
+            free(_in);
+            free(_out);
+        }
+        _placed.release();
+        free(_tmp);
+        _context = NULL;
+        _in = NULL;
+        _out = _tmp = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {_in, NULL, 1};
+        FFTBuffer out = {&_out->real, &_out->imag, 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        layout.packing = FFTPackingHalf;
+        layout.forwardScale = 2;
+        return layout;
+    }
+
+private:
+    bool allocBuffers(int length) {
+        _in = (float *)calloc(length, sizeof(float));
+        _out = (CkFftComplex *)calloc(length / 2 + 1, sizeof(CkFftComplex));
+        _tmp = (CkFftComplex *)calloc(length / 2 + 1, sizeof(CkFftComplex));
+        return _in && _out && _tmp;
+    }
+
+    int _length;
+    CkFftContext *_context;
+    bool _shared;
+    float *_in;
+    CkFftComplex *_out;
+    CkFftComplex *_tmp;
+    FFTPlacementBuffers _placed;
+};
+
+FFT_REGISTER_REAL_BACKEND("ckfft-r", 60, FFTBackendCkFFTReal);
@@ -0,0 +1,126 @@
+//
+//  FFTBackendFFTN.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+#include "fftn.h"
+
+#include <stdlib.h>
+
+/// fftnf: in-place, split float. Scratch is kept in fftn.c globals until fft_free().
+static inline void FFTBackendFFTNRun(float *real, float *imag, int length, int sign) {
+    int dim[] = {length};
+    fftnf(1, dim, real, imag, sign, 1);
+}
+
+static inline void FFTBackendFFTNRun(double *real, double *imag, int length, int sign) {
+    int dim[] = {length};
+    fftn(1, dim, real, imag, sign, 1);
+}
+
+/// Length of the factor list fftn.c's factorize() builds for `length`: square factors (16, 9, 25, ...,
+/// and 4 of what is left) are listed twice, the remaining primes once. It writes into a static
+/// table of NFACTOR (11) entries before checking the count, so longer lists must never reach it.
+static int FFTBackendFFTNFactors(int length) {
+    int n = length, squares = 0, singles = 0;
+    while (n % 16 == 0) {
+        squares++;
+        n /= 16;
+    }
+    int j = 3;
+    do {
+        while (n % (j * j) == 0) {
+            squares++;
+            n /= j * j;
+        }
+        j += 2;
+    } while (j * j <= n);
+    if (n <= 4) {
+        if (n != 1) singles++;
+    } else {
+        if (n % 4 == 0) {
+            squares++;
+            n /= 4;
+        }
+        j = 2;
+        do {
+            if (n % j == 0) {
+                singles++;
+                n /= j;
+            }
+            j = ((j + 1) / 2 << 1) + 1;
+        } while (j <= n);
+    }
+    return squares * 2 + singles;
+}
+
+#define FFTBackendFFTNMaxFactors 11
+
+/// fftn/fftnf: in-place split buffers, T is float or double.
+template <typename T>
+class FFTBackendFFTN : public FFTBackend {
+public:
+    FFTBackendFFTN() : _length(0), _real(NULL), _imag(NULL) {}
+
+    bool supports(int length) const { // mixed radix, any factor, up to 2^22 for powers of two
+        return length > 0 && FFTBackendFFTNFactors(length) <= FFTBackendFFTNMaxFactors;
+    }
+
+    bool setup(int length) {
+        _length = length;
+        _real = (T *)calloc(length, sizeof(T));
+        _imag = (T *)calloc(length, sizeof(T));
+        return _real && _imag;
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) { // imaginary half as the second buffer
+        bool own = _placed.isEmpty();
+        T *real = (T *)_placed.alloc(sizeof(T) * length, placement.offset);
+        T *imag = (T *)_placed.alloc(sizeof(T) * length, FFTPlacementSecondOffset(placement));
+        if (!real || !imag) return false;
+        if (own) {
+            free(_real);
+            free(_imag);
+        }
+        _real = real;
+        _imag = imag;
+        return true;
+    }
+
+    void forward() { FFTBackendFFTNRun(_real, _imag, _length, -1); }
+    void inverse() { FFTBackendFFTNRun(_real, _imag, _length, 1); }
+
+    void teardown() {
+        fft_free();
+        if (_placed.isEmpty()) {
+            free(_real);
+            free(_imag);
+        }
+        _placed.release();
+        _real = _imag = NULL;
+    }
+
+    bool isReentrant() const { return false; } // Tmp0..Tmp3/Perm are file statics in fftn.c, shared by both precisions
+
+    FFTLayout layout() const {
+        FFTBuffer buf = {_real, _imag, 1};
+        FFTPrecision precision = sizeof(T) == sizeof(double) ? FFTPrecisionDouble : FFTPrecisionFloat;
+        FFTLayout layout = FFTLayoutMake(precision, buf, buf);
+        return layout;
+    }
+
+private:
+    int _length;
+    T *_real;
+    T *_imag;
+    FFTPlacementBuffers _placed;
+};
+
+typedef FFTBackendFFTN<float> FFTBackendFFTNFloat;
+typedef FFTBackendFFTN<double> FFTBackendFFTNDouble;
+
+FFT_REGISTER_BACKEND("fftn", 20, FFTBackendFFTNFloat);
+FFT_REGISTER_TRACK_BACKEND("fftn-d", 20, FFTTransformComplex, FFTPrecisionDouble, FFTBackendFFTNDouble);
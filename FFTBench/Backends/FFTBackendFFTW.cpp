@@ -0,0 +1,293 @@
+//
+//  FFTBackendFFTW.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+
+#if FFTBENCH_HAVE_FFTW || FFTBENCH_HAVE_FFTW_DOUBLE
+#include "fftw3.h"
+#endif
+
+#if FFTBENCH_HAVE_FFTW
+
+/// fftwf: out-of-place, interleaved float, FFTW_ESTIMATE plans (FFTW_MEASURE for fftw-measure).
+/// Shared instances run the owner's plans on their own arrays with the new-array execute API.
+class FFTBackendFFTW : public FFTBackend {
+public:
+    explicit FFTBackendFFTW(unsigned flags = FFTW_ESTIMATE)
+        : _flags(flags), _plan(NULL), _iplan(NULL), _shared(false), _in(NULL), _out(NULL) {}
+
+    bool supports(int length) const { return length > 0; }
+
+    bool setup(int length) {
+        _in = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
+        _out = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
+        if (!_in || !_out) return false;
+        {
+            FFTPlanScope plan; // fftw is a shared library: its heap is not counted
+            _plan = fftwf_plan_dft_1d(length, _in, _out, FFTW_FORWARD, _flags);
+            _iplan = fftwf_plan_dft_1d(length, _out, _in, FFTW_BACKWARD, _flags);
+        }
+        return _plan && _iplan;
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        FFTBackendFFTW *fftw = static_cast<FFTBackendFFTW *>(owner);
+        _plan = fftw->_plan;
+        _iplan = fftw->_iplan;
+        _shared = true;
+        _in = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
+        _out = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
+        return _plan && _iplan && _in && _out;
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        bool own = _placed.isEmpty();
+        fftwf_complex *in = (fftwf_complex *)_placed.alloc(sizeof(fftwf_complex) * length, placement.offset);
+        fftwf_complex *out = (fftwf_complex *)_placed.alloc(sizeof(fftwf_complex) * length, FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        // new-array execute needs the SIMD alignment the plan was made for
+        if (fftwf_alignment_of((float *)in) != fftwf_alignment_of((float *)_in) ||
+            fftwf_alignment_of((float *)out) != fftwf_alignment_of((float *)_out)) return false;
+        if (own) {
+            fftwf_free(_in);
+            fftwf_free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { fftwf_execute_dft(_plan, _in, _out); }
+    void inverse() { fftwf_execute_dft(_iplan, _out, _in); }
+
+    void teardown() {
+        if (_plan && !_shared) fftwf_destroy_plan(_plan);
+        if (_iplan && !_shared) fftwf_destroy_plan(_iplan);
+        if (_placed.isEmpty()) {
+            fftwf_free(_in);
+            fftwf_free(_out);
+        }
+        _placed.release();
+        _plan = _iplan = NULL;
+        _in = _out = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {&_in[0][0], &_in[0][1], 2};
+        FFTBuffer out = {&_out[0][0], &_out[0][1], 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        return layout;
+    }
+
+private:
+    unsigned _flags;
+    fftwf_plan _plan;
+    fftwf_plan _iplan;
+    bool _shared;
+    fftwf_complex *_in;
+    fftwf_complex *_out;
+    FFTPlacementBuffers _placed;
+};
+
+// FFTW_MEASURE plans are opt-in, planning times candidate algorithms for up to seconds
+static FFTBackend *FFTBackendFFTW_createMeasure(void) {
+    return new FFTBackendFFTW(FFTW_MEASURE);
+}
+
+FFT_REGISTER_BACKEND("fftw", 70, FFTBackendFFTW);
+static FFTBackendRegistrar FFTBackendFFTW_registrarMeasure("fftw-measure", 71, FFTTransformComplex, FFTPrecisionFloat,
+                                                           FFTBackendFFTW_createMeasure, true);
+
+
+/// fftwf r2c/c2r: real float input, N/2+1 interleaved bins. c2r keeps its input (FFTW_PRESERVE_INPUT)
+/// so the spectrum can be transformed repeatedly, as with the other libraries.
+class FFTBackendFFTWReal : public FFTBackend {
+public:
+    explicit FFTBackendFFTWReal(unsigned flags = FFTW_ESTIMATE)
+        : _flags(flags), _plan(NULL), _iplan(NULL), _shared(false), _in(NULL), _out(NULL) {}
+
+    bool supports(int length) const { return length > 0 && length % 2 == 0; }
+
+    bool setup(int length) {
+        if (!allocBuffers(length)) return false;
+        {
+            FFTPlanScope plan;
+            _plan = fftwf_plan_dft_r2c_1d(length, _in, _out, _flags);
+            _iplan = fftwf_plan_dft_c2r_1d(length, _out, _in, _flags | FFTW_PRESERVE_INPUT);
+        }
+        return _plan && _iplan;
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        FFTBackendFFTWReal *fftw = static_cast<FFTBackendFFTWReal *>(owner);
+        _plan = fftw->_plan;
+        _iplan = fftw->_iplan;
+        _shared = true;
+        return _plan && _iplan && allocBuffers(length);
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        bool own = _placed.isEmpty();
+        float *in = (float *)_placed.alloc(sizeof(float) * length, placement.offset);
+        fftwf_complex *out = (fftwf_complex *)_placed.alloc(sizeof(fftwf_complex) * (length / 2 + 1), FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        // new-array execute needs the SIMD alignment the plan was made for
+        if (fftwf_alignment_of((float *)in) != fftwf_alignment_of((float *)_in) ||
+            fftwf_alignment_of((float *)out) != fftwf_alignment_of((float *)_out)) return false;
+        if (own) {
+            fftwf_free(_in);
+            fftwf_free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { fftwf_execute_dft_r2c(_plan, _in, _out); }
+    void inverse() { fftwf_execute_dft_c2r(_iplan, _out, _in); }
+
+    void teardown() {
+        if (_plan && !_shared) fftwf_destroy_plan(_plan);
+        if (_iplan && !_shared) fftwf_destroy_plan(_iplan);
+        if (_placed.isEmpty()) {
+            fftwf_free(_in);
+            fftwf_free(_out);
+        }
+        _placed.release();
+        _plan = _iplan = NULL;
+        _in = NULL;
+        _out = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {_in, NULL, 1};
+        FFTBuffer out = {&_out[0][0], &_out[0][1], 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        layout.packing = FFTPackingHalf;
+        return layout;
+    }
+
+private:
+    bool allocBuffers(int length) {
+        _in = (float *)fftwf_malloc(sizeof(float) * length);
+        _out = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * (length / 2 + 1));
+        return _in && _out;
+    }
+
+    unsigned _flags;
+    fftwf_plan _plan;
+    fftwf_plan _iplan;
+    bool _shared;
+    float *_in;
+    fftwf_complex *_out;
+    FFTPlacementBuffers _placed;
+};
+
+static FFTBackend *FFTBackendFFTWReal_createMeasure(void) {
+    return new FFTBackendFFTWReal(FFTW_MEASURE);
+}
+
+FFT_REGISTER_REAL_BACKEND("fftw-r", 70, FFTBackendFFTWReal);
+static FFTBackendRegistrar FFTBackendFFTWReal_registrarMeasure("fftw-r-measure", 71, FFTTransformReal,
+                                                               FFTPrecisionFloat, FFTBackendFFTWReal_createMeasure, true);
+
+#endif
+
+
+#if FFTBENCH_HAVE_FFTW_DOUBLE
+
+/// fftw (double): out-of-place, interleaved double, FFTW_ESTIMATE or FFTW_MEASURE plans, shared like fftwf.
+class FFTBackendFFTWDouble : public FFTBackend {
+public:
+    explicit FFTBackendFFTWDouble(unsigned flags = FFTW_ESTIMATE)
+        : _flags(flags), _plan(NULL), _iplan(NULL), _shared(false), _in(NULL), _out(NULL) {}
+
+    bool supports(int length) const { return length > 0; }
+
+    bool setup(int length) {
+        _in = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * length);
+        _out = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * length);
+        if (!_in || !_out) return false;
+        {
+            FFTPlanScope plan;
+            _plan = fftw_plan_dft_1d(length, _in, _out, FFTW_FORWARD, _flags);
+            _iplan = fftw_plan_dft_1d(length, _out, _in, FFTW_BACKWARD, _flags);
+        }
+        return _plan && _iplan;
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        FFTBackendFFTWDouble *fftw = static_cast<FFTBackendFFTWDouble *>(owner);
+        _plan = fftw->_plan;
+        _iplan = fftw->_iplan;
+        _shared = true;
+        _in = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * length);
+        _out = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * length);
+        return _plan && _iplan && _in && _out;
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        bool own = _placed.isEmpty();
+        fftw_complex *in = (fftw_complex *)_placed.alloc(sizeof(fftw_complex) * length, placement.offset);
+        fftw_complex *out = (fftw_complex *)_placed.alloc(sizeof(fftw_complex) * length, FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        // new-array execute needs the SIMD alignment the plan was made for
+        if (fftw_alignment_of((double *)in) != fftw_alignment_of((double *)_in) ||
+            fftw_alignment_of((double *)out) != fftw_alignment_of((double *)_out)) return false;
+        if (own) {
+            fftw_free(_in);
+            fftw_free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { fftw_execute_dft(_plan, _in, _out); }
+    void inverse() { fftw_execute_dft(_iplan, _out, _in); }
+
+    void teardown() {
+        if (_plan && !_shared) fftw_destroy_plan(_plan);
+        if (_iplan && !_shared) fftw_destroy_plan(_iplan);
+        if (_placed.isEmpty()) {
+            fftw_free(_in);
+            fftw_free(_out);
+        }
+        _placed.release();
+        _plan = _iplan = NULL;
+        _in = _out = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {&_in[0][0], &_in[0][1], 2};
+        FFTBuffer out = {&_out[0][0], &_out[0][1], 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionDouble, in, out);
+        return layout;
+    }
+
+private:
+    unsigned _flags;
+    fftw_plan _plan;
+    fftw_plan _iplan;
+    bool _shared;
+    fftw_complex *_in;
+    fftw_complex *_out;
+    FFTPlacementBuffers _placed;
+};
+
+static FFTBackend *FFTBackendFFTWDouble_createMeasure(void) {
+    return new FFTBackendFFTWDouble(FFTW_MEASURE);
+}
+
+FFT_REGISTER_TRACK_BACKEND("fftw-d", 70, FFTTransformComplex, FFTPrecisionDouble, FFTBackendFFTWDouble);
+static FFTBackendRegistrar FFTBackendFFTWDouble_registrarMeasure("fftw-d-measure", 71, FFTTransformComplex,
+                                                                 FFTPrecisionDouble, FFTBackendFFTWDouble_createMeasure, true);
+
+#endif
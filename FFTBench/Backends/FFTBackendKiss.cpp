@@ -0,0 +1,101 @@
+//
+//  FFTBackendKiss.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+#include "kiss_fft.h"
+
+#include <stdlib.h>
+
+/// kiss_fft: interleaved float, one cfg per direction, out-of-place or on one buffer. In place kiss_fft_stride
+/// transforms into a KISS_FFT_TMP_ALLOC buffer and copies it back.
+/// The cfg is only read by the transforms, so it can be shared.
+class FFTBackendKiss : public FFTBackend {
+public:
+    explicit FFTBackendKiss(bool inPlace = false)
+        : _cfg(NULL), _icfg(NULL), _shared(false), _inPlace(inPlace), _in(NULL), _out(NULL) {}
+
+    bool supports(int length) const { return length > 0; } // mixed radix, generic butterfly for odd primes
+
+    bool setup(int length) {
+        {
+            FFTPlanScope plan;
+            _cfg = kiss_fft_alloc(length, 0, NULL, NULL);
+            _icfg = kiss_fft_alloc(length, 1, NULL, NULL);
+        }
+        return _cfg && _icfg && allocBuffers(length);
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        FFTBackendKiss *kiss = static_cast<FFTBackendKiss *>(owner);
+        _cfg = kiss->_cfg;
+        _icfg = kiss->_icfg;
+        _shared = true;
+        return _cfg && _icfg && allocBuffers(length);
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) { // scalar code, any address
+        bool own = _placed.isEmpty();
+        size_t bytes = sizeof(kiss_fft_cpx) * length;
+        kiss_fft_cpx *in = (kiss_fft_cpx *)_placed.alloc(bytes, placement.offset);
+        kiss_fft_cpx *out = _inPlace ? in : (kiss_fft_cpx *)_placed.alloc(bytes, FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        if (own) freeBuffers();
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { kiss_fft(_cfg, _in, _out); }
+    void inverse() { kiss_fft(_icfg, _out, _in); }
+
+    void teardown() {
+        if (!_shared) {
+            kiss_fft_free(_cfg);
+            kiss_fft_free(_icfg);
+        }
+        if (_placed.isEmpty()) freeBuffers();
+        _placed.release();
+        _cfg = _icfg = NULL;
+        _in = _out = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {&_in->r, &_in->i, 2};
+        FFTBuffer out = {&_out->r, &_out->i, 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        return layout;
+    }
+
+private:
+    bool allocBuffers(int length) {
+        _in = (kiss_fft_cpx *)calloc(length, sizeof(kiss_fft_cpx));
+        _out = _inPlace ? _in : (kiss_fft_cpx *)calloc(length, sizeof(kiss_fft_cpx));
+        return _in && _out;
+    }
+
+    void freeBuffers() {
+        if (_out != _in) free(_out);
+        free(_in);
+    }
+
+    kiss_fft_cfg _cfg;
+    kiss_fft_cfg _icfg;
+    bool _shared;
+    bool _inPlace;
+    kiss_fft_cpx *_in;
+    kiss_fft_cpx *_out;
+    FFTPlacementBuffers _placed;
+};
+
+FFT_REGISTER_BACKEND("kiss", 30, FFTBackendKiss);
+
+// opt-in: kiss_fft(cfg, buf, buf), the heap (or alloca) temporary of every in-place call; latency mode runs it
+// by default
+static FFTBackend *FFTBackendKiss_createInPlace(void) { return new FFTBackendKiss(true); }
+static FFTBackendRegistrar FFTBackendKiss_registrarInPlace("kiss-ip", 30, FFTTransformComplex, FFTPrecisionFloat,
+                                                           FFTBackendKiss_createInPlace, true);
@@ -0,0 +1,108 @@
+//
+//  FFTBackendKissSIMD.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+
+#if FFTBENCH_HAVE_KISS_SIMD
+
+// compiled with USE_SIMD and the kiss_fft_simd_* renames of CMakeLists.txt
+#include "kiss_fft.h"
+
+/// kiss_fft built with USE_SIMD: kiss_fft_scalar is __m128, so every call runs four
+/// independent transforms, one per lane (layout.lanes). Out-of-place, interleaved
+/// vectors: lane 0 of sample n is float 8n (real) and 8n+4 (imaginary).
+class FFTBackendKissSIMD : public FFTBackend {
+public:
+    FFTBackendKissSIMD() : _cfg(NULL), _icfg(NULL), _shared(false), _in(NULL), _out(NULL) {}
+
+    bool supports(int length) const { return length > 0; }
+
+    bool setup(int length) {
+        {
+            FFTPlanScope plan;
+            _cfg = kiss_fft_alloc(length, 0, NULL, NULL);
+            _icfg = kiss_fft_alloc(length, 1, NULL, NULL);
+        }
+        return _cfg && _icfg && allocBuffers(length);
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        FFTBackendKissSIMD *kiss = static_cast<FFTBackendKissSIMD *>(owner);
+        _cfg = kiss->_cfg;
+        _icfg = kiss->_icfg;
+        _shared = true;
+        return _cfg && _icfg && allocBuffers(length);
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        if (placement.offset % sizeof(__m128)) return false; // __m128 loads and stores fault elsewhere
+        bool own = _placed.isEmpty();
+        size_t bytes = sizeof(kiss_fft_cpx) * length;
+        kiss_fft_cpx *in = (kiss_fft_cpx *)_placed.alloc(bytes, placement.offset);
+        kiss_fft_cpx *out = (kiss_fft_cpx *)_placed.alloc(bytes, FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        if (own) {
+            KISS_FFT_FREE(_in);
+            KISS_FFT_FREE(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { kiss_fft(_cfg, _in, _out); }
+    void inverse() { kiss_fft(_icfg, _out, _in); }
+
+    void teardown() {
+        if (!_shared) {
+            if (_cfg) KISS_FFT_FREE(_cfg);
+            if (_icfg) KISS_FFT_FREE(_icfg);
+        }
+        if (_placed.isEmpty()) {
+            if (_in) KISS_FFT_FREE(_in);
+            if (_out) KISS_FFT_FREE(_out);
+        }
+        _placed.release();
+        _cfg = _icfg = NULL;
+        _in = _out = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {&_in->r, &_in->i, 8};
+        FFTBuffer out = {&_out->r, &_out->i, 8};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        layout.lanes = 4;
+        return layout;
+    }
+
+private:
+    bool allocBuffers(int length) {
+        size_t bytes = sizeof(kiss_fft_cpx) * length;
+        _in = (kiss_fft_cpx *)KISS_FFT_MALLOC(bytes);
+        _out = (kiss_fft_cpx *)KISS_FFT_MALLOC(bytes);
+        if (!_in || !_out) return false;
+        memset(_in, 0, bytes);
+        memset(_out, 0, bytes);
+        return true;
+    }
+
+    kiss_fft_cfg _cfg;
+    kiss_fft_cfg _icfg;
+    bool _shared;
+    kiss_fft_cpx *_in;
+    kiss_fft_cpx *_out;
+    FFTPlacementBuffers _placed;
+};
+
+// opt-in: one call is four transforms, so its time per call does not compare with the sweep's other
+// contenders; --batch runs it by default on its lane path
+static FFTBackend *FFTBackendKissSIMD_create(void) { return new FFTBackendKissSIMD(); }
+static FFTBackendRegistrar FFTBackendKissSIMD_registrar("kiss-simd", 31, FFTTransformComplex, FFTPrecisionFloat,
+                                                        FFTBackendKissSIMD_create, true);
+
+#endif
@@ -0,0 +1,66 @@
+//
+//  FFTBackendMyFFT.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+#include "myfft.h"
+
+#include <stdlib.h>
+
+/// The myfft or myfftd entry of the element type.
+static inline void FFTBackendMyFFTRun(float *data, int length, int sign) { myfft(data, length, sign); }
+static inline void FFTBackendMyFFTRun(double *data, int length, int sign) { myfftd(data, length, sign); }
+
+/// myfft/myfftd: in-place interleaved radix-2, T is float or double.
+template <typename T>
+class FFTBackendMyFFT : public FFTBackend {
+public:
+    FFTBackendMyFFT() : _length(0), _data(NULL) {}
+
+    bool supports(int length) const { return FFTSizeIsPow2(length); } // radix-2
+
+    bool setup(int length) {
+        _length = length;
+        _data = (T *)calloc(length * 2, sizeof(T));
+        return _data != NULL;
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) { // one buffer, scalar code
+        bool own = _placed.isEmpty();
+        T *data = (T *)_placed.alloc(sizeof(T) * length * 2, placement.offset);
+        if (!data) return false;
+        if (own) free(_data);
+        _data = data;
+        return true;
+    }
+
+    void forward() { FFTBackendMyFFTRun(_data, _length, -1); }
+    void inverse() { FFTBackendMyFFTRun(_data, _length, 1); }
+
+    void teardown() {
+        if (_placed.isEmpty()) free(_data);
+        _placed.release();
+        _data = NULL;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer buf = {_data, _data + 1, 2};
+        FFTPrecision precision = sizeof(T) == sizeof(double) ? FFTPrecisionDouble : FFTPrecisionFloat;
+        FFTLayout layout = FFTLayoutMake(precision, buf, buf);
+        return layout;
+    }
+
+private:
+    int _length;
+    T *_data;
+    FFTPlacementBuffers _placed;
+};
+
+typedef FFTBackendMyFFT<float> FFTBackendMyFFTFloat;
+typedef FFTBackendMyFFT<double> FFTBackendMyFFTDouble;
+
+FFT_REGISTER_BACKEND("myfft", 10, FFTBackendMyFFTFloat);
+FFT_REGISTER_TRACK_BACKEND("myfft-d", 10, FFTTransformComplex, FFTPrecisionDouble, FFTBackendMyFFTDouble);
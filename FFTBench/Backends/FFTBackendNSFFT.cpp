@@ -0,0 +1,157 @@
+//
+//  FFTBackendNSFFT.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+
+#include <stdint.h>
+#include <string.h>
+#include "nsfft.h"
+
+/// nsfft: in-place, one complex value per SIMD vector pair (sizeOfVect bytes per component);
+/// every lane of the vectors is an independent transform, published as layout.lanes.
+/// The plan keeps per-call state (s, offsets), so it is never shared between threads.
+/// With DFT_FLAG_REAL the N real samples are one per vector and the result is N/2 bins with the
+/// Nyquist bin in bin 0; the inverse is scaled by N/2. DFT_FLAG_ALT_REAL runs the transform with the
+/// opposite sign, so the spectrum is conjugated (forward is +1 there).
+/// `mode` 0 picks the fastest SIMD mode of `type` at setup, otherwise it is fixed (if available here).
+/// `flags` may add a DFT_FLAG_*_TEST_RUN level: DFT_init then times radix2thres/cobra choices itself.
+class FFTBackendNSFFT : public FFTBackend {
+public:
+    explicit FFTBackendNSFFT(int32_t type = SIMDBase_TYPE_FLOAT, int32_t mode = SIMDBase_MODE_NONE, uint64_t flags = 0)
+        : _type(type), _fixedMode(mode), _flags(flags), _mode(0), _sizeOfVect(0), _dft(NULL), _data(NULL) {}
+
+    bool supports(int length) const {
+        if (_fixedMode != SIMDBase_MODE_NONE && SIMDBase_detect(_fixedMode) != 1) return false; // not built or no cpu support
+        return FFTSizeIsPow2(length) && length >= (isReal() ? 4 : 2);
+    }
+
+    bool setup(int length) {
+        {
+            FFTPlanScope plan; // the mode choice times the SIMD modes, part of the library's planning
+            _mode = _fixedMode != SIMDBase_MODE_NONE ? _fixedMode : SIMDBase_chooseBestMode(_type);
+            _dft = DFT_init(_mode, length, _flags);
+        }
+        _sizeOfVect = SIMDBase_getModeParamInt(SIMDBase_PARAMID_SIZE_OF_VECT, _mode);
+        _data = (char *)SIMDBase_alignedMalloc(_sizeOfVect * length * 2);
+        if (!_dft || !_data) return false;
+        memset(_data, 0, _sizeOfVect * length * 2);
+        return true;
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        if (placement.offset % _sizeOfVect) return false; // aligned vector loads and stores of the mode
+        bool own = _placed.isEmpty();
+        char *data = (char *)_placed.alloc(_sizeOfVect * length * 2, placement.offset);
+        if (!data) return false;
+        if (own) SIMDBase_alignedFree(_data);
+        _data = data;
+        return true;
+    }
+
+    void forward() { DFT_execute(_dft, _mode, _data, sign()); }
+    void inverse() { DFT_execute(_dft, _mode, _data, -sign()); }
+
+    void teardown() {
+        if (_dft) DFT_dispose(_dft, _mode);
+        if (_data && _placed.isEmpty()) SIMDBase_alignedFree(_data);
+        _placed.release();
+        _dft = NULL;
+        _data = NULL;
+    }
+
+    FFTLayout layout() const {
+        bool isDouble = (_type == SIMDBase_TYPE_DOUBLE);
+        FFTPrecision precision = isDouble ? FFTPrecisionDouble : FFTPrecisionFloat;
+        size_t scalar = isDouble ? sizeof(double) : sizeof(float);
+        long vect = _sizeOfVect / scalar;
+        FFTBuffer buf = {_data, _data + _sizeOfVect, vect * 2};
+        if (!isReal()) {
+            FFTLayout layout = FFTLayoutMake(precision, buf, buf);
+            layout.lanes = (int)vect;
+            return layout;
+        }
+
+        FFTBuffer in = {_data, NULL, vect};
+        FFTLayout layout = FFTLayoutMake(precision, in, buf);
+        layout.lanes = (int)vect;
+        layout.packing = FFTPackingNyquistInDC;
+        layout.inverseScale = 0.5;
+        layout.conjugated = (_flags & DFT_FLAG_ALT_REAL) != 0;
+        return layout;
+    }
+
+private:
+    bool isReal() const { return (_flags & (DFT_FLAG_REAL | DFT_FLAG_ALT_REAL)) != 0; }
+    int sign() const { return (_flags & DFT_FLAG_ALT_REAL) ? 1 : -1; }
+
+    int32_t _type;
+    int32_t _fixedMode;
+    uint64_t _flags;
+    int _mode;
+    int _sizeOfVect;
+    DFT *_dft;
+    char *_data;
+    FFTPlacementBuffers _placed;
+};
+
+static FFTBackend *FFTBackendNSFFT_createReal(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_FLOAT, SIMDBase_MODE_NONE, DFT_FLAG_REAL);
+}
+static FFTBackend *FFTBackendNSFFT_createAltReal(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_FLOAT, SIMDBase_MODE_NONE, DFT_FLAG_ALT_REAL);
+}
+static FFTBackend *FFTBackendNSFFT_createLight(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_FLOAT, SIMDBase_MODE_NONE, DFT_FLAG_LIGHT_TEST_RUN);
+}
+static FFTBackend *FFTBackendNSFFT_createHeavy(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_FLOAT, SIMDBase_MODE_NONE, DFT_FLAG_HEAVY_TEST_RUN);
+}
+static FFTBackend *FFTBackendNSFFT_createExhaustive(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_FLOAT, SIMDBase_MODE_NONE, DFT_FLAG_EXHAUSTIVE_TEST_RUN);
+}
+static FFTBackend *FFTBackendNSFFT_createDouble(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_DOUBLE);
+}
+static FFTBackend *FFTBackendNSFFT_createDoubleC(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_DOUBLE, SIMDBase_MODE_PUREC_DOUBLE);
+}
+static FFTBackend *FFTBackendNSFFT_createDoubleSSE2(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_DOUBLE, SIMDBase_MODE_SSE2_DOUBLE);
+}
+static FFTBackend *FFTBackendNSFFT_createDoubleAVX(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_DOUBLE, SIMDBase_MODE_AVX_DOUBLE);
+}
+static FFTBackend *FFTBackendNSFFT_createDoubleReal(void) {
+    return new FFTBackendNSFFT(SIMDBase_TYPE_DOUBLE, SIMDBase_MODE_NONE, DFT_FLAG_REAL);
+}
+
+FFT_REGISTER_BACKEND("nsfft", 40, FFTBackendNSFFT);
+static FFTBackendRegistrar FFTBackendNSFFT_registrarReal("nsfft-r", 40, FFTTransformReal, FFTPrecisionFloat,
+                                                         FFTBackendNSFFT_createReal);
+static FFTBackendRegistrar FFTBackendNSFFT_registrarAltReal("nsfft-altr", 41, FFTTransformReal, FFTPrecisionFloat,
+                                                            FFTBackendNSFFT_createAltReal);
+
+// DFT_init test runs: setup cost against what the tuned plan buys. Opt-in, each setup above
+// 256 points busy-waits 0.5 s before calibrating.
+static FFTBackendRegistrar FFTBackendNSFFT_registrarLight("nsfft-light", 42, FFTTransformComplex, FFTPrecisionFloat,
+                                                          FFTBackendNSFFT_createLight, true);
+static FFTBackendRegistrar FFTBackendNSFFT_registrarHeavy("nsfft-heavy", 43, FFTTransformComplex, FFTPrecisionFloat,
+                                                          FFTBackendNSFFT_createHeavy, true);
+static FFTBackendRegistrar FFTBackendNSFFT_registrarExhaustive("nsfft-exh", 44, FFTTransformComplex, FFTPrecisionFloat,
+                                                               FFTBackendNSFFT_createExhaustive, true);
+
+// double: the best mode, and each mode on its own to see what the SIMD paths buy over plain C
+static FFTBackendRegistrar FFTBackendNSFFT_registrarDouble("nsfft-d", 40, FFTTransformComplex, FFTPrecisionDouble,
+                                                           FFTBackendNSFFT_createDouble);
+static FFTBackendRegistrar FFTBackendNSFFT_registrarDoubleC("nsfft-d-c", 41, FFTTransformComplex, FFTPrecisionDouble,
+                                                            FFTBackendNSFFT_createDoubleC);
+static FFTBackendRegistrar FFTBackendNSFFT_registrarDoubleSSE2("nsfft-d-sse2", 42, FFTTransformComplex, FFTPrecisionDouble,
+                                                               FFTBackendNSFFT_createDoubleSSE2);
+static FFTBackendRegistrar FFTBackendNSFFT_registrarDoubleAVX("nsfft-d-avx", 43, FFTTransformComplex, FFTPrecisionDouble,
+                                                              FFTBackendNSFFT_createDoubleAVX);
+static FFTBackendRegistrar FFTBackendNSFFT_registrarDoubleReal("nsfft-r-d", 40, FFTTransformReal, FFTPrecisionDouble,
+                                                               FFTBackendNSFFT_createDoubleReal);
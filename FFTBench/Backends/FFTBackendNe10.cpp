@@ -0,0 +1,145 @@
+//
+//  FFTBackendNe10.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+#include "NE10_fft.h"
+
+#include <stdlib.h>
+
+/// ne10: out-of-place, interleaved float. The inverse is already scaled by 1/N.
+/// The cfg embeds its scratch buffer, so it is never shared between threads.
+class FFTBackendNe10 : public FFTBackend {
+public:
+    FFTBackendNe10() : _length(0), _cfg(NULL), _in(NULL), _out(NULL) {}
+
+    bool supports(int length) const { return FFTSizeIsPow2(length) && length >= 2; } // ne10_factor: 4 and 2 only
+
+    bool setup(int length) {
+        _length = length;
+        {
+            FFTPlanScope plan; // its scratch buffer is part of the cfg
+            _cfg = ne10_fft_alloc_c2c_float32(length);
+        }
+        _in = (ne10_fft_cpx_float32_t *)calloc(length, sizeof(ne10_fft_cpx_float32_t));
+        _out = (ne10_fft_cpx_float32_t *)calloc(length, sizeof(ne10_fft_cpx_float32_t));
+        return _cfg && _in && _out;
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) { // NE10_FFT_BYTE_ALIGNMENT is for its cfg only
+        bool own = _placed.isEmpty();
+        size_t bytes = sizeof(ne10_fft_cpx_float32_t) * length;
+        ne10_fft_cpx_float32_t *in = (ne10_fft_cpx_float32_t *)_placed.alloc(bytes, placement.offset);
+        ne10_fft_cpx_float32_t *out = (ne10_fft_cpx_float32_t *)_placed.alloc(bytes, FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        if (own) {
+            free(_in);
+            free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { ne10_fft_c2c_1d_float32(_out, _in, _cfg, 0); }
+    void inverse() { ne10_fft_c2c_1d_float32(_in, _out, _cfg, 1); }
+
+    void teardown() {
+        free(_cfg);
+        if (_placed.isEmpty()) {
+            free(_in);
+            free(_out);
+        }
+        _placed.release();
+        _cfg = NULL;
+        _in = _out = NULL;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {&_in->r, &_in->i, 2};
+        FFTBuffer out = {&_out->r, &_out->i, 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        layout.inverseScale = 1.0 / _length;
+        return layout;
+    }
+
+private:
+    int _length;
+    ne10_fft_cfg_float32_t _cfg;
+    ne10_fft_cpx_float32_t *_in;
+    ne10_fft_cpx_float32_t *_out;
+    FFTPlacementBuffers _placed;
+};
+
+FFT_REGISTER_BACKEND("ne10", 80, FFTBackendNe10);
+
+
+/// ne10 r2c/c2r: real float input, N/2+1 interleaved bins. c2r is scaled by 1/N like the c2c inverse.
+class FFTBackendNe10Real : public FFTBackend {
+public:
+    FFTBackendNe10Real() : _length(0), _cfg(NULL), _in(NULL), _out(NULL) {}
+
+    bool supports(int length) const { return FFTSizeIsPow2(length) && length >= 4; } // N/2 point c2c inside
+
+    bool setup(int length) {
+        _length = length;
+        {
+            FFTPlanScope plan;
+            _cfg = ne10_fft_alloc_r2c_float32(length);
+        }
+        _in = (float *)calloc(length, sizeof(float));
+        _out = (ne10_fft_cpx_float32_t *)calloc(length / 2 + 1, sizeof(ne10_fft_cpx_float32_t));
+        return _cfg && _in && _out;
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        bool own = _placed.isEmpty();
+        float *in = (float *)_placed.alloc(sizeof(float) * length, placement.offset);
+        ne10_fft_cpx_float32_t *out = (ne10_fft_cpx_float32_t *)_placed.alloc(
+            sizeof(ne10_fft_cpx_float32_t) * (length / 2 + 1), FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        if (own) {
+            free(_in);
+            free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { ne10_fft_r2c_1d_float32(_out, _in, _cfg); }
+    void inverse() { ne10_fft_c2r_1d_float32(_in, _out, _cfg); }
+
+    void teardown() {
+        free(_cfg);
+        if (_placed.isEmpty()) {
+            free(_in);
+            free(_out);
+        }
+        _placed.release();
+        _cfg = NULL;
+        _in = NULL;
+        _out = NULL;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {_in, NULL, 1};
+        FFTBuffer out = {&_out->r, &_out->i, 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        layout.packing = FFTPackingHalf;
+        layout.inverseScale = 1.0 / _length;
+        return layout;
+    }
+
+private:
+    int _length;
+    ne10_fft_r2c_cfg_float32_t _cfg;
+    float *_in;
+    ne10_fft_cpx_float32_t *_out;
+    FFTPlacementBuffers _placed;
+};
+
+FFT_REGISTER_REAL_BACKEND("ne10-r", 80, FFTBackendNe10Real);
@@ -0,0 +1,198 @@
+//
+//  FFTBackendPFFFT.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+#include "pffft.h"
+
+#include <string.h>
+
+/// pffft puts its scratch buffer (as large as the input) on the stack when passed NULL; past this
+/// size it gets a heap buffer instead, a 2^20-point transform would need 8 MB of stack.
+#define FFTPFFFTStackScratchBytes (1 << 20)
+
+/// VALIGNED in pffft.c: buffers must sit on a 16-byte boundary (SSE, NEON, Altivec).
+#define FFTPFFFTAlignment 16
+
+/// pffft: ordered out-of-place transform, interleaved float, SIMD-aligned buffers.
+class FFTBackendPFFFT : public FFTBackend {
+public:
+    FFTBackendPFFFT() : _setup(NULL), _shared(false), _in(NULL), _out(NULL), _work(NULL) {}
+
+    bool supports(int length) const {
+        // pffft_new_setup asserts N % (SIMD_SZ * SIMD_SZ) == 0, factors must be 2, 3, 5
+        int simd = pffft_simd_size();
+        return length % (simd * simd) == 0 && length >= 16 && FFTSizeIsSmooth235(length);
+    }
+
+    bool setup(int length) {
+        {
+            FFTPlanScope plan;
+            _setup = pffft_new_setup(length, PFFFT_COMPLEX); // valid length >= 16
+        }
+        return _setup && allocBuffers(length);
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        _setup = static_cast<FFTBackendPFFFT *>(owner)->_setup; // read-only, shareable by design
+        _shared = true;
+        return _setup && allocBuffers(length);
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        if (placement.offset % FFTPFFFTAlignment) return false; // VALIGNED asserts on input and output
+        bool own = _placed.isEmpty();
+        size_t bytes = length * 2 * sizeof(float);
+        float *in = (float *)_placed.alloc(bytes, placement.offset);
+        float *out = (float *)_placed.alloc(bytes, FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        if (own) {
+            pffft_aligned_free(_in);
+            pffft_aligned_free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { pffft_transform_ordered(_setup, _in, _out, _work, PFFFT_FORWARD); }
+    void inverse() { pffft_transform_ordered(_setup, _out, _in, _work, PFFFT_BACKWARD); }
+
+    void teardown() {
+        if (_setup && !_shared) pffft_destroy_setup(_setup);
+        if (_placed.isEmpty()) {
+            pffft_aligned_free(_in);
+            pffft_aligned_free(_out);
+        }
+        _placed.release();
+        pffft_aligned_free(_work);
+        _setup = NULL;
+        _in = _out = _work = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {_in, _in + 1, 2};
+        FFTBuffer out = {_out, _out + 1, 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        return layout;
+    }
+
+private:
+    bool allocBuffers(int length) {
+        size_t bytes = length * 2 * sizeof(float);
+        _in = (float *)pffft_aligned_malloc(bytes);
+        _out = (float *)pffft_aligned_malloc(bytes);
+        if (!_in || !_out) return false;
+        memset(_in, 0, bytes);
+        memset(_out, 0, bytes);
+        if (bytes > FFTPFFFTStackScratchBytes) {
+            _work = (float *)pffft_aligned_malloc(bytes);
+            if (!_work) return false;
+        }
+        return true;
+    }
+
+    PFFFT_Setup *_setup;
+    bool _shared;
+    float *_in;
+    float *_out;
+    float *_work;   ///< NULL: scratch on the stack
+    FFTPlacementBuffers _placed;
+};
+
+FFT_REGISTER_BACKEND("pffft", 50, FFTBackendPFFFT);
+
+
+/// pffft real: ordered out-of-place, real float input, N/2 interleaved bins with Nyquist in bin 0.
+class FFTBackendPFFFTReal : public FFTBackend {
+public:
+    FFTBackendPFFFTReal() : _setup(NULL), _shared(false), _in(NULL), _out(NULL), _work(NULL) {}
+
+    bool supports(int length) const {
+        // PFFFT_REAL asserts N % (2 * SIMD_SZ * SIMD_SZ) == 0
+        int simd = pffft_simd_size();
+        return length % (2 * simd * simd) == 0 && length >= 32 && FFTSizeIsSmooth235(length);
+    }
+
+    bool setup(int length) {
+        {
+            FFTPlanScope plan;
+            _setup = pffft_new_setup(length, PFFFT_REAL);
+        }
+        return _setup && allocBuffers(length);
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        _setup = static_cast<FFTBackendPFFFTReal *>(owner)->_setup;
+        _shared = true;
+        return _setup && allocBuffers(length);
+    }
+
+    bool relocate(int length, const FFTPlacement &placement) {
+        if (placement.offset % FFTPFFFTAlignment) return false; // VALIGNED asserts on input and output
+        bool own = _placed.isEmpty();
+        size_t bytes = length * sizeof(float);
+        float *in = (float *)_placed.alloc(bytes, placement.offset);
+        float *out = (float *)_placed.alloc(bytes, FFTPlacementSecondOffset(placement));
+        if (!in || !out) return false;
+        if (own) {
+            pffft_aligned_free(_in);
+            pffft_aligned_free(_out);
+        }
+        _in = in;
+        _out = out;
+        return true;
+    }
+
+    void forward() { pffft_transform_ordered(_setup, _in, _out, _work, PFFFT_FORWARD); }
+    void inverse() { pffft_transform_ordered(_setup, _out, _in, _work, PFFFT_BACKWARD); }
+
+    void teardown() {
+        if (_setup && !_shared) pffft_destroy_setup(_setup);
+        if (_placed.isEmpty()) {
+            pffft_aligned_free(_in);
+            pffft_aligned_free(_out);
+        }
+        _placed.release();
+        pffft_aligned_free(_work);
+        _setup = NULL;
+        _in = _out = _work = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {_in, NULL, 1};
+        FFTBuffer out = {_out, _out + 1, 2};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        layout.packing = FFTPackingNyquistInDC;
+        return layout;
+    }
+
+private:
+    bool allocBuffers(int length) {
+        size_t bytes = length * sizeof(float);
+        _in = (float *)pffft_aligned_malloc(bytes);
+        _out = (float *)pffft_aligned_malloc(bytes);
+        if (!_in || !_out) return false;
+        memset(_in, 0, bytes);
+        memset(_out, 0, bytes);
+        if (bytes > FFTPFFFTStackScratchBytes) {
+            _work = (float *)pffft_aligned_malloc(bytes);
+            if (!_work) return false;
+        }
+        return true;
+    }
+
+    PFFFT_Setup *_setup;
+    bool _shared;
+    float *_in;
+    float *_out;
+    float *_work;   ///< NULL: scratch on the stack
+    FFTPlacementBuffers _placed;
+};
+
+FFT_REGISTER_REAL_BACKEND("pffft-r", 50, FFTBackendPFFFTReal);
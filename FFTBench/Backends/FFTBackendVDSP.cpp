@@ -0,0 +1,191 @@
+//
+//  FFTBackendVDSP.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+
+#if __APPLE__
+
+#include <Accelerate/Accelerate.h>
+#include <math.h>
+#include <stdlib.h>
+
+/// vDSP complex FFT on split buffers (radix-2 setup, power-of-two lengths only).
+class FFTBackendVDSP : public FFTBackend {
+public:
+    typedef enum {
+        VariantOutOfPlace,      ///< vDSP_fft_zop
+        VariantInPlaceTmpBuf,   ///< vDSP_fft_zipt
+        VariantInPlace,         ///< vDSP_fft_zip
+    } Variant;
+
+    explicit FFTBackendVDSP(Variant variant) : _variant(variant), _log2n(0), _setup(NULL), _shared(false) {
+        _a.realp = _a.imagp = NULL;
+        _b.realp = _b.imagp = NULL;
+    }
+
+    bool supports(int length) const { return FFTSizeIsPow2(length) && length >= 2; } // FFT_RADIX2 setup
+
+    bool setup(int length) {
+        _log2n = log2f((float)length);
+        {
+            FFTPlanScope plan;
+            _setup = vDSP_create_fftsetup(_log2n, FFT_RADIX2);
+        }
+        return _setup && allocBuffers(length);
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        _log2n = log2f((float)length);
+        _setup = static_cast<FFTBackendVDSP *>(owner)->_setup; // read-only after creation
+        _shared = true;
+        return _setup && allocBuffers(length);
+    }
+
+    void forward() {
+        switch (_variant) {
+            case VariantOutOfPlace: vDSP_fft_zop(_setup, &_a, 1, &_b, 1, _log2n, FFT_FORWARD); break;
+            case VariantInPlaceTmpBuf: vDSP_fft_zipt(_setup, &_a, 1, &_b, _log2n, FFT_FORWARD); break;
+            case VariantInPlace: vDSP_fft_zip(_setup, &_a, 1, _log2n, FFT_FORWARD); break;
+        }
+    }
+
+    void inverse() {
+        switch (_variant) {
+            case VariantOutOfPlace: vDSP_fft_zop(_setup, &_b, 1, &_a, 1, _log2n, FFT_INVERSE); break;
+            case VariantInPlaceTmpBuf: vDSP_fft_zipt(_setup, &_a, 1, &_b, _log2n, FFT_INVERSE); break;
+            case VariantInPlace: vDSP_fft_zip(_setup, &_a, 1, _log2n, FFT_INVERSE); break;
+        }
+    }
+
+    void teardown() {
+        if (_setup && !_shared) vDSP_destroy_fftsetup(_setup);
+        free(_a.realp);
+        free(_a.imagp);
+        free(_b.realp);
+        free(_b.imagp);
+        _setup = NULL;
+        _a.realp = _a.imagp = NULL;
+        _b.realp = _b.imagp = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {_a.realp, _a.imagp, 1};
+        FFTBuffer out = in;
+        if (_variant == VariantOutOfPlace) {
+            FFTBuffer b = {_b.realp, _b.imagp, 1};
+            out = b;
+        }
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        return layout;
+    }
+
+private:
+    bool allocBuffers(int length) {
+        _a.realp = (float *)calloc(length, sizeof(float));
+        _a.imagp = (float *)calloc(length, sizeof(float));
+        if (!_a.realp || !_a.imagp) return false;
+        if (_variant != VariantInPlace) {
+            _b.realp = (float *)calloc(length, sizeof(float));
+            _b.imagp = (float *)calloc(length, sizeof(float));
+            if (!_b.realp || !_b.imagp) return false;
+        }
+        return true;
+    }
+
+    Variant _variant;
+    vDSP_Length _log2n;
+    FFTSetup _setup;
+    bool _shared;
+    DSPSplitComplex _a;
+    DSPSplitComplex _b;   ///< output (zop) or tmp buffer (zipt)
+};
+
+static FFTBackend *FFTBackendVDSP_createZop(void) { return new FFTBackendVDSP(FFTBackendVDSP::VariantOutOfPlace); }
+static FFTBackend *FFTBackendVDSP_createZipt(void) { return new FFTBackendVDSP(FFTBackendVDSP::VariantInPlaceTmpBuf); }
+static FFTBackend *FFTBackendVDSP_createZip(void) { return new FFTBackendVDSP(FFTBackendVDSP::VariantInPlace); }
+
+static FFTBackendRegistrar FFTBackendVDSP_registrarZop("vdsp", 90, FFTTransformComplex, FFTPrecisionFloat, FFTBackendVDSP_createZop);
+static FFTBackendRegistrar FFTBackendVDSP_registrarZipt("vdsp-zipt", 91, FFTTransformComplex, FFTPrecisionFloat, FFTBackendVDSP_createZipt);
+static FFTBackendRegistrar FFTBackendVDSP_registrarZip("vdsp-zip", 92, FFTTransformComplex, FFTPrecisionFloat, FFTBackendVDSP_createZip);
+
+
+/// vDSP_fft_zrip: in-place real FFT on a split buffer of N/2 even/odd samples, result scaled by 2 with
+/// Nyquist in bin 0. The samples are kept interleaved and split/merged with vDSP_ctoz/ztoc in each
+/// call, like the original real benchmark.
+class FFTBackendVDSPReal : public FFTBackend {
+public:
+    FFTBackendVDSPReal() : _log2n(0), _setup(NULL), _shared(false), _signal(NULL) {
+        _split.realp = _split.imagp = NULL;
+    }
+
+    bool supports(int length) const { return FFTSizeIsPow2(length) && length >= 4; }
+
+    bool setup(int length) {
+        _log2n = log2f((float)length);
+        {
+            FFTPlanScope plan;
+            _setup = vDSP_create_fftsetup(_log2n, FFT_RADIX2);
+        }
+        return _setup && allocBuffers(length);
+    }
+
+    bool setupShared(FFTBackend *owner, int length) {
+        _log2n = log2f((float)length);
+        _setup = static_cast<FFTBackendVDSPReal *>(owner)->_setup;
+        _shared = true;
+        return _setup && allocBuffers(length);
+    }
+
+    void forward() {
+        vDSP_ctoz((DSPComplex *)_signal, 2, &_split, 1, (1 << _log2n) / 2);
+        vDSP_fft_zrip(_setup, &_split, 1, _log2n, FFT_FORWARD);
+    }
+
+    void inverse() {
+        vDSP_fft_zrip(_setup, &_split, 1, _log2n, FFT_INVERSE);
+        vDSP_ztoc(&_split, 1, (DSPComplex *)_signal, 2, (1 << _log2n) / 2);
+    }
+
+    void teardown() {
+        if (_setup && !_shared) vDSP_destroy_fftsetup(_setup);
+        free(_signal);
+        free(_split.realp);
+        free(_split.imagp);
+        _setup = NULL;
+        _signal = NULL;
+        _split.realp = _split.imagp = NULL;
+        _shared = false;
+    }
+
+    FFTLayout layout() const {
+        FFTBuffer in = {_signal, NULL, 1};
+        FFTBuffer out = {_split.realp, _split.imagp, 1};
+        FFTLayout layout = FFTLayoutMake(FFTPrecisionFloat, in, out);
+        layout.packing = FFTPackingNyquistInDC;
+        layout.forwardScale = 2;
+        return layout;
+    }
+
+private:
+    bool allocBuffers(int length) {
+        _signal = (float *)calloc(length, sizeof(float));
+        _split.realp = (float *)calloc(length / 2, sizeof(float));
+        _split.imagp = (float *)calloc(length / 2, sizeof(float));
+        return _signal && _split.realp && _split.imagp;
+    }
+
+    vDSP_Length _log2n;
+    FFTSetup _setup;
+    bool _shared;
+    float *_signal;
+    DSPSplitComplex _split;
+};
+
+FFT_REGISTER_REAL_BACKEND("vdsp-r", 90, FFTBackendVDSPReal);
+
+#endif
@@ -0,0 +1,225 @@
+//
+//  FFTAlignment.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTAlignment.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+#define FFTAlignmentOffsetCount 6
+
+static const int FFTAlignmentOffsets[FFTAlignmentOffsetCount] = {0, 4, 8, 16, 32, 64};
+
+/// record and column names, [aliased][offset]
+static const char *FFTAlignmentNames[2][FFTAlignmentOffsetCount] = {
+    {"+0", "+4", "+8", "+16", "+32", "+64"},
+    {"+0/4k", "+4/4k", "+8/4k", "+16/4k", "+32/4k", "+64/4k"},
+};
+
+
+/// One timed placement of a backend.
+struct FFTAlignmentCell {
+    bool measured;
+    bool copied;        ///< the library could not run there, timing is copy + transform
+    bool valid;
+    FFTTiming timing;
+    FFTError error;
+};
+
+
+/// Check the forward transform of a set-up backend, then time it; with `copy` (and for in-place
+/// backends, whose forward overwrites the input) the input is copied in before every call.
+static FFTAlignmentCell FFTAlignmentMeasure(FFTBackend *backend, int length, bool copy,
+                                            const double *data_real, const double *data_imag,
+                                            const double *idft_real, const double *idft_imag,
+                                            const FFTBenchOptions &options) {
+    FFTAlignmentCell cell = FFTAlignmentCell();
+    FFTLayout layout = backend->layout();
+    std::vector<double> real(length), imag(length);
+    FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+    backend->forward();
+    FFTSpectrumStore(layout, real.data(), imag.data(), length, 1.0 / layout.forwardScale);
+    cell.error = FFTErrorCompute(real.data(), imag.data(), idft_real, idft_imag, FFTLayoutSpectrumBins(layout, length));
+    cell.valid = cell.error.rms <= FFTBenchTolerance(layout.precision);
+
+    FFTBufferImage image;
+    FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+    image.capture(layout.input, layout.precision, length, layout.lanes);
+    bool restore = copy || FFTLayoutIsInPlace(layout);
+    long batch = options.points / length / options.timer.trials;
+    FFTTimerOptions timer = options.timer;
+    if (batch < 1 && timer.budget <= 0) timer.budget = FFTBenchLargeBudget;
+    cell.timing = FFTTimerMeasure(timer, batch, [&](long n) {
+        for (long r = 0; r < n; r++) {
+            if (restore) image.restore();
+            backend->forward();
+        }
+    });
+    cell.measured = true;
+    cell.copied = copy;
+    return cell;
+}
+
+
+static FFTRecord FFTAlignmentRecord(const FFTBackendInfo *info, int length, bool inPlace, const char *placement,
+                                    const FFTAlignmentCell &cell) {
+    FFTRecord record = FFTRecord();
+    record.backend = info->name;
+    record.length = length;
+    record.precision = info->precision;
+    record.transform = info->transform;
+    record.inPlace = inPlace;
+    record.direction = "fwd";
+    record.threads = 1;
+    record.premarshal = true;
+    record.status = cell.valid ? FFTBenchStatusOK : FFTBenchStatusInvalid;
+    record.timing = cell.timing;
+    record.error = cell.error;
+    record.peakBytes = -1;
+    record.placement = placement;
+    record.copied = cell.copied;
+    return record;
+}
+
+
+int FFTAlignmentRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    FFTBenchPrintEnvironment();
+    printf("alignment: forward ns in the library's own buffers and relocated past a page boundary\n");
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        int length = lengths[l];
+        printf("%d-------\n", length);
+
+        std::vector<double> data_real(length), data_imag(length);
+        std::vector<double> idft_real(length), idft_imag(length);
+        FFTBenchGenerateInput(data_real.data(), data_imag.data(), length);
+        FFTReferenceDFT(data_real.data(), data_imag.data(), idft_real.data(), idft_imag.data(), length, -1);
+
+        std::vector<std::string> labels;
+        std::vector<std::vector<double> > ratios;
+        std::vector<std::vector<bool> > copies;
+        for (size_t b = 0; b < backends.size(); b++) {
+            const FFTBackendInfo *info = backends[b];
+            std::string label = std::string(info->name) + ":";
+            FFTBackend *probe = info->create();
+            bool supported = probe->supports(length);
+            delete probe;
+            if (!supported) continue;
+
+            FFTBackend *backend = info->create();
+            if (!backend->setup(length)) {
+                printf("%-6s setup failed\n", label.c_str());
+                backend->teardown();
+                delete backend;
+                FFTRecord record = FFTRecord();
+                record.backend = info->name;
+                record.length = length;
+                record.precision = info->precision;
+                record.transform = info->transform;
+                record.direction = "fwd";
+                record.threads = 1;
+                record.premarshal = true;
+                record.status = FFTBenchStatusSetupFailed;
+                records.push_back(record);
+                failures++;
+                continue;
+            }
+            FFTLayout layout = backend->layout();
+            bool inPlace = FFTLayoutIsInPlace(layout);
+            bool split = layout.input.imag && layout.input.stride == 1;
+            bool aliasable = !inPlace || split; // two streams to put on the same page offset
+            double flops = FFTRooflineFlops(length, info->transform);
+            FFTAlignmentCell own = FFTAlignmentMeasure(backend, length, false, data_real.data(), data_imag.data(),
+                                                       idft_real.data(), idft_imag.data(), options);
+            FFTAlignmentCell copy = FFTAlignmentCell();
+            FFTBenchPrintTiming(label.c_str(), "own", own.timing, flops);
+            records.push_back(FFTAlignmentRecord(info, length, inPlace, "own", own));
+            if (!own.valid) failures++;
+
+            std::vector<double> row(2 * FFTAlignmentOffsetCount, 0);
+            std::vector<bool> copied(2 * FFTAlignmentOffsetCount, false);
+            for (int a = 0; a < 2; a++) {
+                if (a && !aliasable) continue;
+                for (int k = 0; k < FFTAlignmentOffsetCount; k++) {
+                    FFTPlacement placement = {FFTAlignmentOffsets[k], a == 1};
+                    const char *name = FFTAlignmentNames[a][k];
+                    FFTBackend *placed = info->create();
+                    FFTAlignmentCell cell;
+                    if (!placed->setup(length)) {
+                        printf("%-6s %-5s setup failed\n", label.c_str(), name);
+                        placed->teardown();
+                        delete placed;
+                        FFTRecord record = FFTAlignmentRecord(info, length, inPlace, name, FFTAlignmentCell());
+                        record.status = FFTBenchStatusSetupFailed;
+                        records.push_back(record);
+                        failures++;
+                        continue;
+                    }
+                    if (placed->relocate(length, placement)) {
+                        cell = FFTAlignmentMeasure(placed, length, false, data_real.data(), data_imag.data(),
+                                                   idft_real.data(), idft_imag.data(), options);
+                        FFTBenchPrintTiming(label.c_str(), name, cell.timing, flops);
+                    } else {
+                        if (!copy.measured) {
+                            copy = FFTAlignmentMeasure(backend, length, true, data_real.data(), data_imag.data(),
+                                                       idft_real.data(), idft_imag.data(), options);
+                            FFTBenchPrintTiming(label.c_str(), "copy", copy.timing, flops);
+                        }
+                        cell = copy;
+                        printf("%-6s %-5s cannot run there, copy into own buffers\n", label.c_str(), name);
+                    }
+                    placed->teardown();
+                    delete placed;
+
+                    records.push_back(FFTAlignmentRecord(info, length, inPlace, name, cell));
+                    if (!cell.valid) {
+                        printf("%-6s %-5s invalid, rms error %.3g\n", label.c_str(), name, cell.error.rms);
+                        failures++;
+                    }
+                    row[a * FFTAlignmentOffsetCount + k] = cell.timing.ns.median / own.timing.ns.median;
+                    copied[a * FFTAlignmentOffsetCount + k] = cell.copied;
+                }
+            }
+            backend->teardown();
+            delete backend;
+            labels.push_back(label);
+            ratios.push_back(row);
+            copies.push_back(copied);
+        }
+
+        printf("slowdown against own buffers  (c: copied into own buffers first, - one buffer, no aliasing)\n");
+        int width = 8;
+        for (size_t r = 0; r < labels.size(); r++) width = std::max(width, (int)labels[r].size());
+        printf("%-*s", width, "");
+        for (int a = 0; a < 2; a++) {
+            for (int k = 0; k < FFTAlignmentOffsetCount; k++) printf(" %7s", FFTAlignmentNames[a][k]);
+        }
+        printf("\n");
+        for (size_t r = 0; r < labels.size(); r++) {
+            printf("%-*s", width, labels[r].c_str());
+            for (size_t c = 0; c < ratios[r].size(); c++) {
+                char cell[16] = "-";
+                if (ratios[r][c] > 0) snprintf(cell, sizeof(cell), "%.2f%s", ratios[r][c], copies[r][c] ? "c" : "");
+                printf(" %7s", cell);
+            }
+            printf("\n");
+        }
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
@@ -0,0 +1,37 @@
+//
+//  FFTAlignment.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTAlignment__
+#define __FFTBench__FFTAlignment__
+
+#include "FFTBench.h"
+
+/*
+ Buffer placement: data arriving in network packets sits at any offset, while
+ the backends allocate their own buffers (calloc, fftwf_malloc,
+ SIMDBase_alignedMalloc, pffft_aligned_malloc). Every backend's forward
+ transform is timed
+
+    own      in the buffers it allocated itself
+    +k       with input and output relocated k bytes past a page boundary
+             (FFTBackend::relocate), the output half a page away
+    +k/4k    the same with the output on the input's page offset, so loads
+             and stores of the two streams 4K-alias
+
+ for k in 0, 4, 8, 16, 32, 64. A library that cannot run at an offset (pffft
+ asserts 16-byte alignment, nsfft and kiss-simd use aligned vector loads,
+ fftw's new-array execute needs the plan's alignment) is timed copying the
+ input into its own buffers before each transform instead. The summary is the
+ slowdown against `own`, marked `c` where the copy was needed. In-place
+ backends copy their input in every time anyway, since forward overwrites it;
+ interleaved ones have one buffer, so their 4K-aliased columns stay empty.
+ */
+
+/// Run the placement benchmark over the lengths of options, return the number of failures.
+int FFTAlignmentRun(const FFTBenchOptions &options);
+
+#endif /* defined(__FFTBench__FFTAlignment__) */
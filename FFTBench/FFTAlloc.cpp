@@ -0,0 +1,167 @@
+//
+//  FFTAlloc.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTAlloc.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#define FFTALLOC_HAS_STACK_PROBE 1
+#endif
+
+#define FFTAllocProbeStack ((size_t)8 << 20)
+#define FFTAllocPaint 0xA5
+
+
+#if FFTBENCH_WRAP_MALLOC
+
+#include <malloc.h>
+
+static __thread bool FFTAllocTracking;
+static __thread long FFTAllocCalls;
+static __thread long long FFTAllocLive;
+static __thread long long FFTAllocPeak;
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+int __real_posix_memalign(void **ptr, size_t alignment, size_t size);
+void __real_free(void *ptr);
+
+static inline void FFTAllocAdd(void *ptr) {
+    if (!FFTAllocTracking || !ptr) return;
+    FFTAllocCalls++;
+    FFTAllocLive += malloc_usable_size(ptr);
+    if (FFTAllocLive > FFTAllocPeak) FFTAllocPeak = FFTAllocLive;
+}
+
+void *__wrap_malloc(size_t size) {
+    void *ptr = __real_malloc(size);
+    FFTAllocAdd(ptr);
+    return ptr;
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    void *ptr = __real_calloc(count, size);
+    FFTAllocAdd(ptr);
+    return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    if (FFTAllocTracking && ptr) FFTAllocLive -= malloc_usable_size(ptr);
+    void *result = __real_realloc(ptr, size);
+    FFTAllocAdd(result);
+    return result;
+}
+
+int __wrap_posix_memalign(void **ptr, size_t alignment, size_t size) {
+    int error = __real_posix_memalign(ptr, alignment, size);
+    if (!error) FFTAllocAdd(*ptr);
+    return error;
+}
+
+void __wrap_free(void *ptr) {
+    if (FFTAllocTracking && ptr) FFTAllocLive -= malloc_usable_size(ptr);
+    __real_free(ptr);
+}
+}
+
+bool FFTAllocAvailable(void) {
+    return true;
+}
+
+void FFTAllocTrack(bool on) {
+    FFTAllocTracking = on;
+}
+
+FFTAllocCount FFTAllocRead(void) {
+    FFTAllocCount count = {FFTAllocCalls, FFTAllocLive, FFTAllocPeak};
+    return count;
+}
+
+void FFTAllocResetPeak(void) {
+    FFTAllocPeak = FFTAllocLive;
+}
+
+#else
+
+bool FFTAllocAvailable(void) {
+    return false;
+}
+
+void FFTAllocTrack(bool on) {
+    (void)on;
+}
+
+FFTAllocCount FFTAllocRead(void) {
+    FFTAllocCount count = {0, 0, 0};
+    return count;
+}
+
+void FFTAllocResetPeak(void) {}
+
+#endif
+
+
+#if FFTALLOC_HAS_STACK_PROBE
+
+struct FFTAllocProbe {
+    void (*block)(void *context);   ///< NULL: measure the baseline of the probe thread itself
+    void *context;
+};
+
+static void *FFTAllocProbeMain(void *context) {
+    FFTAllocProbe *probe = (FFTAllocProbe *)context;
+    if (probe->block) probe->block(probe->context);
+    return NULL;
+}
+
+/// Deepest stack use of a thread running `probe`, -1 on failure.
+static long FFTAllocProbeDepth(FFTAllocProbe *probe) {
+    void *stack = NULL;
+    if (posix_memalign(&stack, 4096, FFTAllocProbeStack) != 0) return -1;
+    memset(stack, FFTAllocPaint, FFTAllocProbeStack);
+
+    long used = -1;
+    pthread_attr_t attr;
+    pthread_t thread;
+    if (pthread_attr_init(&attr) == 0) {
+        if (pthread_attr_setstack(&attr, stack, FFTAllocProbeStack) == 0 &&
+            pthread_create(&thread, &attr, FFTAllocProbeMain, probe) == 0) {
+            pthread_join(thread, NULL);
+            const unsigned char *bytes = (const unsigned char *)stack;
+            size_t untouched = 0;
+            while (untouched < FFTAllocProbeStack && bytes[untouched] == FFTAllocPaint) untouched++;
+            used = (long)(FFTAllocProbeStack - untouched); // stacks grow down
+        }
+        pthread_attr_destroy(&attr);
+    }
+    free(stack);
+    return used;
+}
+
+long FFTAllocStackUse(void (*block)(void *context), void *context) {
+    FFTAllocProbe base = {NULL, NULL};
+    FFTAllocProbe probe = {block, context};
+    long baseDepth = FFTAllocProbeDepth(&base);
+    long depth = FFTAllocProbeDepth(&probe);
+    return (baseDepth < 0 || depth < 0) ? -1 : depth - baseDepth;
+}
+
+#else
+
+long FFTAllocStackUse(void (*block)(void *context), void *context) {
+    (void)block;
+    (void)context;
+    return -1;
+}
+
+#endif
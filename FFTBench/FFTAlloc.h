@@ -0,0 +1,49 @@
+//
+//  FFTAlloc.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTAlloc__
+#define __FFTBench__FFTAlloc__
+
+/*
+ Memory accounting of the calling thread.
+
+ Heap: the executable is linked with -Wl,--wrap=malloc,... (FFTBENCH_WRAP_MALLOC,
+ GNU ld), which reroutes every malloc/calloc/realloc/posix_memalign/free of the
+ statically linked code, vendor libraries included. Shared libraries (fftw)
+ and libstdc++'s operator new are not seen.
+
+    FFTAllocTrack(true);
+    FFTAllocCount before = FFTAllocRead();
+    backend->setup(length);
+    FFTAllocCount after = FFTAllocRead();   // after.live - before.live: bytes the plan keeps
+
+ Stack: FFTAllocStackUse runs a block on a thread whose stack is painted with
+ a pattern, and reports how deep the pattern was overwritten.
+ */
+
+struct FFTAllocCount {
+    long calls;        ///< allocations while tracked
+    long long live;    ///< usable bytes allocated minus freed while tracked
+    long long peak;    ///< highest `live` since the last FFTAllocResetPeak()
+};
+
+/// Whether this build counts the heap.
+bool FFTAllocAvailable(void);
+
+/// Start or stop counting on this thread.
+void FFTAllocTrack(bool on);
+
+/// Totals of this thread, zero if not available.
+FFTAllocCount FFTAllocRead(void);
+
+/// Restart the peak at the current live bytes.
+void FFTAllocResetPeak(void);
+
+/// Stack bytes `block(context)` uses beyond an empty block, -1 if it cannot be measured here.
+long FFTAllocStackUse(void (*block)(void *context), void *context);
+
+#endif /* defined(__FFTBench__FFTAlloc__) */
@@ -0,0 +1,229 @@
+//
+//  FFTBackend.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+
+static std::vector<FFTBackendInfo> &FFTBackendList() {
+    static std::vector<FFTBackendInfo> list; // filled by static registrars, before main()
+    return list;
+}
+
+static bool FFTBackendInfoLess(const FFTBackendInfo &a, const FFTBackendInfo &b) {
+    if (a.order != b.order) return a.order < b.order;
+    return strcmp(a.name, b.name) < 0;
+}
+
+const std::vector<FFTBackendInfo> &FFTBackendRegistry::backends() {
+    return FFTBackendList();
+}
+
+const FFTBackendInfo *FFTBackendRegistry::find(const char *name) {
+    const std::vector<FFTBackendInfo> &list = FFTBackendList();
+    for (size_t i = 0; i < list.size(); i++) {
+        if (strcmp(list[i].name, name) == 0) return &list[i];
+    }
+    return NULL;
+}
+
+void FFTBackendRegistry::add(const char *name, int order, FFTTransform transform, FFTPrecision precision,
+                             FFTBackendFactory create, bool optIn) {
+    std::vector<FFTBackendInfo> &list = FFTBackendList();
+    FFTBackendInfo info = {name, order, transform, precision, create, optIn};
+    list.insert(std::upper_bound(list.begin(), list.end(), info, FFTBackendInfoLess), info);
+}
+
+
+static thread_local FFTPlanCost FFTPlanTotal;
+static thread_local int FFTPlanDepth;
+
+void FFTPlanReset(void) {
+    FFTPlanTotal = FFTPlanCost();
+}
+
+FFTPlanCost FFTPlanRead(void) {
+    return FFTPlanTotal;
+}
+
+FFTPlanScope::FFTPlanScope() : _outer(FFTPlanDepth++ == 0), _heap(FFTAllocRead()), _start(FFTTimerNanoseconds()) {}
+
+FFTPlanScope::~FFTPlanScope() {
+    uint64_t end = FFTTimerNanoseconds();
+    FFTPlanDepth--;
+    if (!_outer) return;
+    FFTAllocCount heap = FFTAllocRead();
+    FFTPlanTotal.ns += (double)(end - _start);
+    FFTPlanTotal.allocs += heap.calls - _heap.calls;
+    FFTPlanTotal.bytes += heap.live - _heap.live;
+}
+
+
+FFTLayout FFTLayoutMake(FFTPrecision precision, const FFTBuffer &input, const FFTBuffer &output) {
+    FFTLayout layout;
+    layout.precision = precision;
+    layout.input = input;
+    layout.output = output;
+    layout.packing = FFTPackingComplex;
+    layout.forwardScale = 1;
+    layout.inverseScale = 1;
+    layout.conjugated = false;
+    layout.lanes = 1;
+    return layout;
+}
+
+void *FFTPlacementBuffers::alloc(size_t bytes, int offset) {
+    char *block = (char *)calloc(bytes + offset + FFTPlacementPage, 1);
+    if (!block) return NULL;
+    _blocks.push_back(block);
+    uintptr_t page = ((uintptr_t)block + FFTPlacementPage - 1) & ~(uintptr_t)(FFTPlacementPage - 1);
+    return (char *)page + offset;
+}
+
+void FFTPlacementBuffers::release() {
+    for (size_t i = 0; i < _blocks.size(); i++) free(_blocks[i]);
+    _blocks.clear();
+}
+
+
+FFTBuffer FFTBufferLane(const FFTBuffer &buf, FFTPrecision precision, int lane) {
+    size_t offset = (size_t)lane * (precision == FFTPrecisionDouble ? sizeof(double) : sizeof(float));
+    FFTBuffer result = {(char *)buf.real + offset, buf.imag ? (char *)buf.imag + offset : NULL, buf.stride};
+    return result;
+}
+
+int FFTLayoutSpectrumBins(const FFTLayout &layout, int length) {
+    return layout.packing == FFTPackingComplex ? length : length / 2 + 1;
+}
+
+int FFTLayoutSpectrumSlots(const FFTLayout &layout, int length) {
+    switch (layout.packing) {
+        case FFTPackingHalf: return length / 2 + 1;
+        case FFTPackingNyquistInDC: return length / 2; // the Nyquist bin shares slot 0
+        default: return length;
+    }
+}
+
+
+template <typename T>
+static void FFTBufferLoadT(const FFTBuffer &buf, const double *real, const double *imag,
+                           int length, double imagScale) {
+    long stride = buf.stride;
+    T *re = (T *)buf.real;
+    T *im = (T *)buf.imag;
+    for (int i = 0; i < length; i++) re[i * stride] = real[i];
+    if (im) {
+        for (int i = 0; i < length; i++) im[i * stride] = imag[i] * imagScale;
+    }
+}
+
+template <typename T>
+static void FFTBufferStoreT(const FFTBuffer &buf, double *real, double *imag,
+                            int length, double scale, double imagScale) {
+    long stride = buf.stride;
+    const T *re = (const T *)buf.real;
+    const T *im = (const T *)buf.imag;
+    for (int i = 0; i < length; i++) real[i] = re[i * stride] * scale;
+    if (im) {
+        for (int i = 0; i < length; i++) imag[i] = im[i * stride] * scale * imagScale;
+    } else {
+        for (int i = 0; i < length; i++) imag[i] = 0;
+    }
+}
+
+void FFTBufferLoad(const FFTBuffer &buf, FFTPrecision precision, const double *real, const double *imag, int length) {
+    if (precision == FFTPrecisionFloat) FFTBufferLoadT<float>(buf, real, imag, length, 1);
+    else FFTBufferLoadT<double>(buf, real, imag, length, 1);
+}
+
+void FFTBufferStore(const FFTBuffer &buf, FFTPrecision precision, double *real, double *imag, int length, double scale) {
+    if (precision == FFTPrecisionFloat) FFTBufferStoreT<float>(buf, real, imag, length, scale, 1);
+    else FFTBufferStoreT<double>(buf, real, imag, length, scale, 1);
+}
+
+
+/// the imaginary slot of bin 0, which holds the Nyquist bin in FFTPackingNyquistInDC
+static void *FFTSpectrumNyquistSlot(const FFTLayout &layout) {
+    return layout.output.imag;
+}
+
+void FFTSpectrumLoad(const FFTLayout &layout, const double *real, const double *imag, int length) {
+    int bins = FFTLayoutSpectrumSlots(layout, length);
+    double imagScale = layout.conjugated ? -1 : 1;
+    bool nyquistInDC = (layout.packing == FFTPackingNyquistInDC);
+
+    if (layout.precision == FFTPrecisionFloat) {
+        FFTBufferLoadT<float>(layout.output, real, imag, bins, imagScale);
+        if (nyquistInDC) *(float *)FFTSpectrumNyquistSlot(layout) = real[bins];
+    } else {
+        FFTBufferLoadT<double>(layout.output, real, imag, bins, imagScale);
+        if (nyquistInDC) *(double *)FFTSpectrumNyquistSlot(layout) = real[bins];
+    }
+}
+
+void FFTSpectrumStore(const FFTLayout &layout, double *real, double *imag, int length, double scale) {
+    int bins = FFTLayoutSpectrumSlots(layout, length);
+    double imagScale = layout.conjugated ? -1 : 1;
+    bool nyquistInDC = (layout.packing == FFTPackingNyquistInDC);
+
+    if (layout.precision == FFTPrecisionFloat) {
+        FFTBufferStoreT<float>(layout.output, real, imag, bins, scale, imagScale);
+        if (nyquistInDC) real[bins] = *(float *)FFTSpectrumNyquistSlot(layout) * scale;
+    } else {
+        FFTBufferStoreT<double>(layout.output, real, imag, bins, scale, imagScale);
+        if (nyquistInDC) real[bins] = *(double *)FFTSpectrumNyquistSlot(layout) * scale;
+    }
+    if (nyquistInDC) {
+        imag[0] = 0;
+        imag[bins] = 0;
+    }
+}
+
+
+void FFTBufferImage::capture(const FFTBuffer &buf, FFTPrecision precision, int length, int lanes) {
+    size_t scalar = (precision == FFTPrecisionFloat) ? sizeof(float) : sizeof(double);
+    size_t span = ((length - 1) * buf.stride + lanes) * scalar;
+    char *real = (char *)buf.real;
+    char *imag = (char *)buf.imag;
+
+    _spans.clear();
+    if (!imag) { // real signal
+        Span r;
+        r.address = real;
+        r.bytes.assign(real, real + span);
+        _spans.push_back(r);
+        return;
+    }
+
+    char *lo = real < imag ? real : imag;
+    char *hi = real < imag ? imag : real;
+    if ((size_t)(hi - lo) < (size_t)buf.stride * scalar) { // interleaved: one block
+        Span s;
+        s.address = lo;
+        s.bytes.assign(lo, hi + span);
+        _spans.push_back(s);
+    } else { // split: two blocks
+        Span r, i;
+        r.address = real;
+        r.bytes.assign(real, real + span);
+        i.address = imag;
+        i.bytes.assign(imag, imag + span);
+        _spans.push_back(r);
+        _spans.push_back(i);
+    }
+}
+
+void FFTBufferImage::restore() const {
+    for (size_t i = 0; i < _spans.size(); i++) {
+        memcpy(_spans[i].address, _spans[i].bytes.data(), _spans[i].bytes.size());
+    }
+}
@@ -0,0 +1,276 @@
+//
+//  FFTBackend.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTBackend__
+#define __FFTBench__FFTBackend__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "FFTSizes.h"
+#include "FFTAlloc.h"
+
+/*
+ Every library under Venders/ is wrapped by one FFTBackend subclass living in
+ FFTBench/Backends/, and registers itself with FFT_REGISTER_BACKEND (complex
+ transforms) or FFT_REGISTER_REAL_BACKEND (r2c/c2r transforms).
+
+ The harness never touches library types: it writes input samples and reads
+ results through the FFTLayout descriptor the backend publishes after setup().
+
+    backend->setup(length);
+    for() {
+      load(layout.input);
+      backend->forward();     // layout.input  -> layout.output
+      backend->inverse();     // layout.output -> layout.input
+    }
+    backend->teardown();
+ */
+
+
+typedef enum {
+    FFTPrecisionFloat,
+    FFTPrecisionDouble,
+} FFTPrecision;
+
+
+typedef enum {
+    FFTTransformComplex,
+    FFTTransformReal,
+} FFTTransform;
+
+
+/// How the spectrum of an N point transform is stored.
+typedef enum {
+    FFTPackingComplex,      ///< N bins
+    FFTPackingHalf,         ///< N/2+1 bins of a real transform (ckfft, ne10, fftw)
+    FFTPackingNyquistInDC,  ///< N/2 bins of a real transform, the real Nyquist bin stored
+                            ///< as imaginary part of bin 0 (pffft, nsfft, vDSP)
+} FFTPacking;
+
+
+/// Where a library keeps N samples.
+struct FFTBuffer {
+    void *real;   ///< first real component
+    void *imag;   ///< first imaginary component, NULL for real-valued signals
+    long stride;  ///< distance between two samples, in scalars (2 for interleaved, 1 for split)
+};
+
+
+/// Memory layout descriptor of a backend, valid between setup() and teardown().
+struct FFTLayout {
+    FFTPrecision precision;
+    FFTBuffer input;        ///< time domain: forward input, inverse output
+    FFTBuffer output;       ///< frequency domain: forward output, inverse input (may equal input for in-place)
+    FFTPacking packing;     ///< of output
+    double forwardScale;    ///< forward result = forwardScale * DFT(x), 2 for ckfft/vDSP real
+    double inverseScale;    ///< inverse result = inverseScale * N * IDFT(X), 1/N for ne10
+    bool conjugated;        ///< spectrum is stored conjugated (nsfft DFT_FLAG_ALT_REAL)
+    int lanes;              ///< independent transforms per call, lane k stored k scalars after lane 0
+                            ///< (one per SIMD lane: nsfft, kiss-simd), 1 for everything else
+};
+
+/// Layout of an unscaled complex transform; backends adjust the remaining fields.
+FFTLayout FFTLayoutMake(FFTPrecision precision, const FFTBuffer &input, const FFTBuffer &output);
+
+/// Number of spectrum bins of a transform of `length` points: N, or N/2+1 for real transforms.
+int FFTLayoutSpectrumBins(const FFTLayout &layout, int length);
+
+/// Number of complex slots layout.output holds, one less than the bins for FFTPackingNyquistInDC.
+int FFTLayoutSpectrumSlots(const FFTLayout &layout, int length);
+
+inline FFTTransform FFTLayoutTransform(const FFTLayout &layout) {
+    return layout.packing == FFTPackingComplex ? FFTTransformComplex : FFTTransformReal;
+}
+
+
+#define FFTPlacementPage 4096
+
+/// Where FFTBackend::relocate() puts the buffers: the first (input) `offset` bytes past a page
+/// boundary, the second (output, or the imaginary half of split data) at the same page offset
+/// when `aliased` (4K aliasing between loads and stores), half a page further otherwise.
+struct FFTPlacement {
+    int offset;
+    bool aliased;
+};
+
+inline int FFTPlacementSecondOffset(const FFTPlacement &placement) {
+    return placement.aliased ? placement.offset : placement.offset + FFTPlacementPage / 2;
+}
+
+/// Page-aligned blocks holding relocated buffers, freed by release() or with the object.
+class FFTPlacementBuffers {
+public:
+    FFTPlacementBuffers() {}
+    ~FFTPlacementBuffers() { release(); }
+
+    /// `bytes` zeroed bytes starting `offset` bytes past a page boundary, NULL if out of memory.
+    void *alloc(size_t bytes, int offset);
+    bool isEmpty() const { return _blocks.empty(); }
+    void release();
+
+private:
+    FFTPlacementBuffers(const FFTPlacementBuffers &);
+    FFTPlacementBuffers &operator=(const FFTPlacementBuffers &);
+
+    std::vector<void *> _blocks;
+};
+
+
+/// Time and heap of the library's plan constructors (kiss_fft_alloc, pffft_new_setup, CkFftInit, DFT_init,
+/// ne10_fft_alloc_*, fftwf_plan_*, vDSP_create_fftsetup) run by setup(), without the backend's own buffers.
+struct FFTPlanCost {
+    double ns;
+    long allocs;       ///< heap allocations, counted while FFTAllocTrack is on
+    long long bytes;   ///< heap the constructors left allocated, likewise
+};
+
+/// Start the plan cost of this thread from zero.
+void FFTPlanReset(void);
+
+/// Plan cost of this thread since FFTPlanReset().
+FFTPlanCost FFTPlanRead(void);
+
+/// Adds the time and heap of its lifetime to the plan cost of this thread; backends open one around their
+/// library's plan constructors. Nested scopes (a planner setting up candidates) count once, as the outer one.
+class FFTPlanScope {
+public:
+    FFTPlanScope();
+    ~FFTPlanScope();
+
+private:
+    FFTPlanScope(const FFTPlanScope &);
+    FFTPlanScope &operator=(const FFTPlanScope &);
+
+    bool _outer;
+    FFTAllocCount _heap;
+    uint64_t _start;
+};
+
+
+class FFTBackend {
+public:
+    virtual ~FFTBackend() {}
+
+    /// Whether the library can transform `length` points; setup() is only called if true.
+    virtual bool supports(int length) const = 0;
+
+    /// Create plan and buffers for a transform of `length` points. Return false if not possible.
+    virtual bool setup(int length) = 0;
+
+    /// Unnormalized forward transform, layout.input -> layout.output.
+    virtual void forward() = 0;
+
+    /// Inverse transform, layout.output -> layout.input.
+    virtual void inverse() = 0;
+
+    /// Release everything created by setup().
+    virtual void teardown() = 0;
+
+    virtual FFTLayout layout() const = 0;
+
+    /// Like setup(), but reuse the read-only plan of `owner` (already set up with `length`)
+    /// and allocate only private buffers. Return false if the library has no shareable plan.
+    /// teardown() of a shared instance leaves the plan to its owner.
+    virtual bool setupShared(FFTBackend *owner, int length) { return false; }
+
+    /// Whether separate instances may transform concurrently (false for global scratch).
+    virtual bool isReentrant() const { return true; }
+
+    /// After setup(), move the buffers to `placement` (as if the caller's data sat there) and keep
+    /// the plan. Return false if the library cannot transform at that address (an alignment it
+    /// asserts or assumes); callers then copy into the buffers of layout().
+    virtual bool relocate(int length, const FFTPlacement &placement) { return false; }
+};
+
+
+typedef FFTBackend *(*FFTBackendFactory)(void);
+
+struct FFTBackendInfo {
+    const char *name;
+    int order;                 ///< display order, as in the original FFTRun
+    FFTTransform transform;
+    FFTPrecision precision;
+    FFTBackendFactory create;
+    bool optIn;                ///< only run when named with -b, e.g. planners whose setup takes seconds
+};
+
+
+class FFTBackendRegistry {
+public:
+    /// All compiled-in backends, sorted by display order.
+    static const std::vector<FFTBackendInfo> &backends();
+
+    /// Lookup by name, NULL if not compiled in.
+    static const FFTBackendInfo *find(const char *name);
+
+    static void add(const char *name, int order, FFTTransform transform, FFTPrecision precision,
+                    FFTBackendFactory create, bool optIn = false);
+};
+
+
+struct FFTBackendRegistrar {
+    FFTBackendRegistrar(const char *name, int order, FFTTransform transform, FFTPrecision precision,
+                        FFTBackendFactory create, bool optIn = false) {
+        FFTBackendRegistry::add(name, order, transform, precision, create, optIn);
+    }
+};
+
+/// Register a backend of the single-precision complex track.
+#define FFT_REGISTER_BACKEND(NAME, ORDER, CLASS) \
+    FFT_REGISTER_TRACK_BACKEND(NAME, ORDER, FFTTransformComplex, FFTPrecisionFloat, CLASS)
+
+/// Register a backend of the single-precision real track.
+#define FFT_REGISTER_REAL_BACKEND(NAME, ORDER, CLASS) \
+    FFT_REGISTER_TRACK_BACKEND(NAME, ORDER, FFTTransformReal, FFTPrecisionFloat, CLASS)
+
+#define FFT_REGISTER_TRACK_BACKEND(NAME, ORDER, TRANSFORM, PRECISION, CLASS) \
+    static FFTBackend *CLASS##_create(void) { return new CLASS(); } \
+    static FFTBackendRegistrar CLASS##_registrar(NAME, ORDER, TRANSFORM, PRECISION, CLASS##_create)
+
+
+/// Whether forward() overwrites its own input.
+inline bool FFTLayoutIsInPlace(const FFTLayout &layout) {
+    return layout.input.real == layout.output.real;
+}
+
+
+/// Copy `length` samples into a backend buffer, converting to its precision.
+/// The imaginary parts are skipped if buf.imag is NULL.
+void FFTBufferLoad(const FFTBuffer &buf, FFTPrecision precision, const double *real, const double *imag, int length);
+
+/// The buffer of SIMD lane `lane` (< layout.lanes), lane 0 being `buf` itself.
+FFTBuffer FFTBufferLane(const FFTBuffer &buf, FFTPrecision precision, int lane);
+
+/// Copy `length` samples out of a backend buffer, multiplied by `scale`.
+/// The imaginary parts are zero if buf.imag is NULL.
+void FFTBufferStore(const FFTBuffer &buf, FFTPrecision precision, double *real, double *imag, int length, double scale);
+
+/// Write the FFTLayoutSpectrumBins bins of a `length` point transform in the backend's packing.
+void FFTSpectrumLoad(const FFTLayout &layout, const double *real, const double *imag, int length);
+
+/// Read the spectrum back as plain bins, multiplied by `scale`.
+void FFTSpectrumStore(const FFTLayout &layout, double *real, double *imag, int length, double scale);
+
+
+/// Raw bytes of a backend buffer, written back with memcpy instead of a per-sample conversion.
+class FFTBufferImage {
+public:
+    /// `lanes` > 1 captures the samples of that many SIMD lanes (layout.lanes) at once.
+    void capture(const FFTBuffer &buf, FFTPrecision precision, int length, int lanes = 1);
+    void restore() const;
+
+private:
+    struct Span {
+        void *address;
+        std::vector<char> bytes;
+    };
+    std::vector<Span> _spans;
+};
+
+#endif /* defined(__FFTBench__FFTBackend__) */
@@ -0,0 +1,193 @@
+//
+//  FFTBaseline.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBaseline.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <map>
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif
+
+
+/// One timed measurement of a baseline file.
+struct FFTBaselineEntry {
+    double median;
+    double ciLow;
+    double ciHigh;
+};
+
+
+/// lower-case letters and digits, every other run of characters becomes one '-'
+static std::string FFTBaselineSlug(const std::string &s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (isalnum(c)) out += (char)tolower(c);
+        else if (!out.empty() && out[out.size() - 1] != '-') out += '-';
+    }
+    while (!out.empty() && out[out.size() - 1] == '-') out.erase(out.size() - 1);
+    return out;
+}
+
+std::string FFTBaselineFingerprint(const FFTMachineInfo &machine) {
+    std::string identity = machine.processor + "|" + machine.arch + "|" + machine.compiler + "|" +
+                           machine.flags + "|" + machine.buildType;
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < identity.size(); i++) {
+        hash ^= (unsigned char)identity[i];
+        hash *= 16777619u;
+    }
+    char hex[16];
+    snprintf(hex, sizeof(hex), "%08x", hash);
+    return FFTBaselineSlug(machine.arch + " " + machine.processor) + "-" + hex;
+}
+
+/// `location` itself if it names a .csv file, else the fingerprint's file inside that directory.
+static std::string FFTBaselinePath(const std::string &location, const FFTMachineInfo &machine) {
+    size_t n = location.size();
+    if (n > 4 && location.compare(n - 4, 4, ".csv") == 0) return location;
+    std::string dir = location;
+    if (dir[dir.size() - 1] != '/') dir += '/';
+    return dir + FFTBaselineFingerprint(machine) + ".csv";
+}
+
+
+static std::string FFTBaselineKey(const std::string &backend, int length, const std::string &precision,
+                                  const std::string &transform, const std::string &layout,
+                                  const std::string &direction, int threads, const std::string &cache,
+                                  bool premarshal, int lanes, const std::string &placement,
+                                  const std::string &signal, const std::string &kernel) {
+    char numbers[64];
+    snprintf(numbers, sizeof(numbers), "%d|%d|%d|%d", length, threads, premarshal ? 1 : 0, lanes);
+    return backend + "|" + precision + "|" + transform + "|" + layout + "|" + direction + "|" + cache + "|" +
+           placement + "|" + signal + "|" + kernel + "|" + numbers;
+}
+
+static std::string FFTBaselineRecordKey(const FFTRecord &r) {
+    return FFTBaselineKey(r.backend, r.length, r.precision == FFTPrecisionDouble ? "double" : "float",
+                          r.transform == FFTTransformReal ? "real" : "complex",
+                          r.inPlace ? "in-place" : "out-of-place", r.direction, r.threads,
+                          r.cache ? r.cache : "", r.premarshal, r.transforms ? r.lanes : 0,
+                          r.placement ? r.placement : "",
+                          r.signal ? std::string(r.signal) + (r.flushDenormals ? "/ftz" : "") : "",
+                          r.stage ? std::string(r.stage) + "/" + std::to_string(r.stride) : "");
+}
+
+
+/// Timed "ok" rows of a baseline file, false if it cannot be read.
+static bool FFTBaselineLoad(const std::string &path, std::map<std::string, FFTBaselineEntry> &entries,
+                            std::string &processor) {
+    std::vector<std::string> header;
+    std::vector<std::map<std::string, std::string> > rows;
+    if (!FFTReportReadCSV(path.c_str(), header, rows)) return false;
+    static const char *required[] = {"processor", "backend", "length", "precision", "transform", "layout",
+                                     "direction", "threads", "status", "median_ns", "ci_low_ns", "ci_high_ns"};
+    for (size_t i = 0; i < sizeof(required) / sizeof(required[0]); i++) {
+        if (std::find(header.begin(), header.end(), required[i]) == header.end()) return false;
+    }
+
+    for (size_t l = 0; l < rows.size(); l++) {
+        std::map<std::string, std::string> &f = rows[l];
+        if (f["status"] != "ok" || f["median_ns"].empty()) continue;
+        processor = f["processor"];
+        std::string signal = f["signal"];
+        if (!signal.empty() && f["ftz"] == "1") signal += "/ftz";
+        std::string kernel = f["stage"];
+        if (!kernel.empty() && f.count("stride")) kernel += "/" + f["stride"];
+        std::string key = FFTBaselineKey(f["backend"], atoi(f["length"].c_str()), f["precision"], f["transform"],
+                                         f["layout"], f["direction"], atoi(f["threads"].c_str()), f["cache"],
+                                         f["premarshal"] == "1", atoi(f["lanes"].c_str()), f["placement"], signal,
+                                         kernel);
+        FFTBaselineEntry entry;
+        entry.median = atof(f["median_ns"].c_str());
+        entry.ciLow = atof(f["ci_low_ns"].c_str());
+        entry.ciHigh = atof(f["ci_high_ns"].c_str());
+        entries[key] = entry;
+    }
+    return true;
+}
+
+
+static bool FFTBaselineSave(const std::string &location, const FFTMachineInfo &machine,
+                            const std::vector<FFTRecord> &records) {
+    std::string path = FFTBaselinePath(location, machine);
+#if !defined(_WIN32)
+    if (path != location) mkdir(location.c_str(), 0755); // a directory: create it, fopen reports the rest
+#endif
+    if (!FFTReportWriteCSV(path.c_str(), machine, records)) {
+        fprintf(stderr, "cannot write baseline %s\n", path.c_str());
+        return false;
+    }
+    printf("baseline saved to %s\n", path.c_str());
+    return true;
+}
+
+
+int FFTBaselineCheck(const FFTBenchOptions &options, const std::vector<FFTRecord> &records) {
+    if (options.baselinePath.empty() && options.saveBaselinePath.empty()) return 0;
+    FFTMachineInfo machine = FFTMachineInfoGet();
+    int failures = 0;
+
+    if (!options.baselinePath.empty()) {
+        std::string path = FFTBaselinePath(options.baselinePath, machine);
+        std::map<std::string, FFTBaselineEntry> baseline;
+        std::string processor;
+        if (!FFTBaselineLoad(path, baseline, processor)) {
+            fprintf(stderr, "no baseline for this machine: cannot read %s (create it with --save-baseline)\n",
+                    path.c_str());
+            failures++;
+        } else {
+            double threshold = options.regressionThreshold / 100.0;
+            int matched = 0, regressions = 0, improvements = 0;
+            printf("\nbaseline %s\n", path.c_str());
+            if (!processor.empty() && processor != machine.processor) {
+                printf("warning: baseline measured on %s\n", processor.c_str());
+            }
+            for (size_t i = 0; i < records.size(); i++) {
+                const FFTRecord &r = records[i];
+                if (r.status != FFTBenchStatusOK || r.timing.ns.count == 0) continue;
+                if (!strcmp(r.direction, "load") || !strcmp(r.direction, "store")) continue; // harness code
+                std::map<std::string, FFTBaselineEntry>::const_iterator it = baseline.find(FFTBaselineRecordKey(r));
+                if (it == baseline.end()) continue;
+                matched++;
+
+                const FFTBaselineEntry &base = it->second;
+                const FFTStats &ns = r.timing.ns;
+                bool slower = ns.median > base.median * (1 + threshold) && ns.ciLow > base.ciHigh;
+                bool faster = ns.median < base.median * (1 - threshold) && ns.ciHigh < base.ciLow;
+                if (!slower && !faster) continue;
+                if (slower) regressions++;
+                else improvements++;
+
+                std::string label = r.backend + ":";
+                printf("%-6s %-5s %8d  med %10.1f -> %10.1f ns  %+6.1f%%  ci95 [%.1f, %.1f] -> [%.1f, %.1f]%s\n",
+                       label.c_str(), r.direction, r.length, base.median, ns.median,
+                       (ns.median / base.median - 1) * 100, base.ciLow, base.ciHigh, ns.ciLow, ns.ciHigh,
+                       slower ? "  ! regression" : "");
+            }
+            printf("baseline: %d of %d matched measurements regressed by more than %g%%, %d improved\n",
+                   regressions, matched, options.regressionThreshold, improvements);
+            if (matched == 0) {
+                fprintf(stderr, "no measurement of this run is in the baseline\n");
+                failures++;
+            }
+            failures += regressions;
+        }
+    }
+
+    if (!options.saveBaselinePath.empty() && !FFTBaselineSave(options.saveBaselinePath, machine, records)) {
+        failures++;
+    }
+    return failures;
+}
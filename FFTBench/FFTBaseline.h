@@ -0,0 +1,43 @@
+//
+//  FFTBaseline.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTBaseline__
+#define __FFTBench__FFTBaseline__
+
+#include "FFTReport.h"
+
+#include <string>
+#include <vector>
+
+/*
+ Regression gate for library upgrades:
+
+    ./FFTBench --save-baseline Result/baselines    # before: Result/baselines/<fingerprint>.csv
+    (replace Venders/pffft/pffft.c, rebuild)
+    ./FFTBench --baseline Result/baselines         # after: exit status 1 on a regression
+
+ A baseline is the --csv output of a run, stored under the fingerprint of the
+ machine (processor, arch, compiler, flags, build type) so a directory can hold
+ the baselines of several machines. Measurements are matched by backend,
+ length, precision, transform, layout, direction, threads, premarshal (input
+ marshalled outside the timed loop), cache, lanes, buffer placement and input
+ signal (with FTZ/DAZ). A match regresses when its
+ median is more than options.regressionThreshold percent slower and the
+ distribution-free 95% confidence intervals of the two medians do not
+ overlap. The load/store phases (harness marshalling) and
+ records without samples (throughput) are not compared. The intervals only
+ cover the noise within one run, so on a busy machine raise --trials or the
+ threshold rather than trusting a single flagged cell.
+ */
+
+/// "x86_64-intel-r-xeon-r-...-1f3a9c07": readable, and different for another compiler or flags.
+std::string FFTBaselineFingerprint(const FFTMachineInfo &machine);
+
+/// Save and/or check the baseline of options, return the number of regressions and I/O errors.
+int FFTBaselineCheck(const FFTBenchOptions &options, const std::vector<FFTRecord> &records);
+
+#endif /* defined(__FFTBench__FFTBaseline__) */
@@ -0,0 +1,283 @@
+//
+//  FFTBatch.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBatch.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#define FFTBatchDefaultTransforms 4096
+
+// largest length tried for the per-call overhead, which runs at the smallest one a backend supports
+#define FFTBatchOverheadMaxLength 64
+
+
+/// One way of running the batch: `calls` transform calls of `lanes` transforms each.
+struct FFTBatchPath {
+    long calls;
+    int lanes;
+    bool inPlace;
+    FFTTiming timing;   ///< ns per transform
+    FFTError error;     ///< worst lane of all instances
+};
+
+
+static void FFTBatchRelease(std::vector<FFTBackend *> &instances) {
+    for (size_t i = 0; i < instances.size(); i++) {
+        instances[i]->teardown();
+        delete instances[i];
+    }
+    instances.clear();
+}
+
+/// `count` instances, sharing the plan of the first where the library allows it; false if a setup failed.
+static bool FFTBatchSetup(const FFTBackendInfo *info, int length, long count, std::vector<FFTBackend *> &instances) {
+    bool shared = true;
+    for (long i = 0; i < count; i++) {
+        FFTBackend *backend = info->create();
+        instances.push_back(backend);
+        if (i == 0) {
+            if (!backend->setup(length)) return false;
+            continue;
+        }
+        if (shared && !backend->setupShared(instances[0], length)) {
+            backend->teardown();
+            shared = false;
+        }
+        if (!shared && !backend->setup(length)) return false;
+    }
+    return true;
+}
+
+/// The layout of SIMD lane `lane`.
+static FFTLayout FFTBatchLaneLayout(const FFTLayout &layout, int lane) {
+    FFTLayout result = layout;
+    result.input = FFTBufferLane(layout.input, layout.precision, lane);
+    result.output = FFTBufferLane(layout.output, layout.precision, lane);
+    return result;
+}
+
+/// Lane k transforms the input scaled by k+1, so a lane reading its neighbour is caught.
+static void FFTBatchLoad(FFTBackend *backend, int lanes, const double *data_real, const double *data_imag,
+                         int length, std::vector<double> &real, std::vector<double> &imag) {
+    FFTLayout layout = backend->layout();
+    for (int k = 0; k < lanes; k++) {
+        for (int i = 0; i < length; i++) {
+            real[i] = data_real[i] * (k + 1);
+            imag[i] = data_imag[i] * (k + 1);
+        }
+        FFTBufferLoad(FFTBufferLane(layout.input, layout.precision, k), layout.precision,
+                      real.data(), imag.data(), length);
+    }
+}
+
+
+/// Time `count` calls with `lanes` transforms each, false if a setup failed.
+static bool FFTBatchMeasure(const FFTBackendInfo *info, int length, long count, int lanes,
+                            const double *data_real, const double *data_imag,
+                            const double *idft_real, const double *idft_imag,
+                            const FFTBenchOptions &options, FFTBatchPath &path) {
+    std::vector<FFTBackend *> instances;
+    if (!FFTBatchSetup(info, length, count, instances)) {
+        FFTBatchRelease(instances);
+        return false;
+    }
+    FFTLayout layout = instances[0]->layout();
+    int bins = FFTLayoutSpectrumBins(layout, length);
+    std::vector<double> real(length), imag(length);
+    path.calls = count;
+    path.lanes = lanes;
+    path.inPlace = FFTLayoutIsInPlace(layout);
+    path.error.rms = path.error.max = 0;
+
+    for (long c = 0; c < count; c++) {
+        FFTBackend *backend = instances[c];
+        FFTBatchLoad(backend, lanes, data_real, data_imag, length, real, imag);
+        backend->forward();
+        FFTLayout own = backend->layout();
+        for (int k = 0; k < lanes; k++) {
+            FFTSpectrumStore(FFTBatchLaneLayout(own, k), real.data(), imag.data(), length,
+                             1.0 / (own.forwardScale * (k + 1)));
+            FFTError error = FFTErrorCompute(real.data(), imag.data(), idft_real, idft_imag, bins);
+            if (!(error.rms <= path.error.rms)) path.error.rms = error.rms; // keeps NaN
+            if (!(error.max <= path.error.max)) path.error.max = error.max;
+        }
+        FFTBatchLoad(backend, lanes, data_real, data_imag, length, real, imag);
+    }
+
+    std::vector<FFTBufferImage> images(path.inPlace ? count : 0);
+    for (size_t c = 0; c < images.size(); c++) {
+        FFTLayout own = instances[c]->layout();
+        images[c].capture(own.input, own.precision, length, lanes);
+    }
+
+    long transforms = count * lanes;
+    long passes = std::max(options.points / length / transforms / options.timer.trials, 1L);
+    path.timing = FFTTimerMeasure(options.timer, passes, [&](long n) {
+        for (long r = 0; r < n; r++) {
+            for (long c = 0; c < count; c++) {
+                if (path.inPlace) images[c].restore();
+                instances[c]->forward();
+            }
+        }
+    });
+    path.timing.ns.min /= transforms;
+    path.timing.ns.median /= transforms;
+    path.timing.ns.p90 /= transforms;
+    path.timing.ns.p99 /= transforms;
+    path.timing.ns.p999 /= transforms;
+    path.timing.ns.max /= transforms;
+    path.timing.ns.mean /= transforms;
+    path.timing.ns.ciLow /= transforms;
+    path.timing.ns.ciHigh /= transforms;
+    path.timing.cycles.median /= transforms;
+
+    FFTBatchRelease(instances);
+    return true;
+}
+
+
+static FFTRecord FFTBatchRecord(const FFTBackendInfo *info, int length, const FFTBatchPath &path) {
+    FFTRecord record = FFTRecord();
+    record.backend = info->name;
+    record.length = length;
+    record.precision = info->precision;
+    record.transform = info->transform;
+    record.inPlace = path.inPlace;
+    record.direction = "fwd";
+    record.threads = 1;
+    record.premarshal = true;
+    record.status = path.error.rms <= FFTBenchTolerance(info->precision) ? FFTBenchStatusOK : FFTBenchStatusInvalid;
+    record.timing = path.timing;
+    record.error = path.error;
+    record.peakBytes = -1;
+    record.transforms = path.calls * path.lanes;
+    record.lanes = path.lanes;
+    return record;
+}
+
+
+int FFTBatchRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    if (options.backends.empty()) { // lane-only backends, opt-in in the sweep
+        const std::vector<FFTBackendInfo> &all = FFTBackendRegistry::backends();
+        for (size_t i = 0; i < all.size(); i++) {
+            if (all[i].transform != options.transform || all[i].precision != options.precision) continue;
+            if (!strcmp(all[i].name, "kiss-simd")) backends.push_back(&all[i]);
+        }
+    }
+    long transforms = options.batchTransforms > 0 ? options.batchTransforms : FFTBatchDefaultTransforms;
+    FFTBenchPrintEnvironment();
+    printf("batch: %ld independent forward transforms per pass, ns per transform\n", transforms);
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        int length = lengths[l];
+        printf("%d-------\n", length);
+
+        std::vector<double> data_real(length), data_imag(length);
+        std::vector<double> idft_real(length), idft_imag(length);
+        FFTBenchGenerateInput(data_real.data(), data_imag.data(), length);
+        FFTReferenceDFT(data_real.data(), data_imag.data(), idft_real.data(), idft_imag.data(), length, -1);
+
+        for (size_t b = 0; b < backends.size(); b++) {
+            const FFTBackendInfo *info = backends[b];
+            std::string label = std::string(info->name) + ":";
+            FFTBackend *probe = info->create();
+            bool supported = probe->supports(length);
+            int lanes = 1;
+            if (supported && probe->setup(length)) lanes = probe->layout().lanes;
+            probe->teardown();
+            delete probe;
+            if (!supported) continue;
+
+            FFTBatchPath call, lane;
+            bool ok = FFTBatchMeasure(info, length, transforms, 1, data_real.data(), data_imag.data(),
+                                      idft_real.data(), idft_imag.data(), options, call);
+            if (ok && lanes > 1) {
+                ok = FFTBatchMeasure(info, length, (transforms + lanes - 1) / lanes, lanes, data_real.data(),
+                                     data_imag.data(), idft_real.data(), idft_imag.data(), options, lane);
+            }
+            if (!ok) {
+                printf("%-6s setup failed\n", label.c_str());
+                FFTRecord record = FFTRecord();
+                record.backend = info->name;
+                record.length = length;
+                record.precision = info->precision;
+                record.transform = info->transform;
+                record.direction = "fwd";
+                record.threads = 1;
+                record.premarshal = true;
+                record.status = FFTBenchStatusSetupFailed;
+                records.push_back(record);
+                failures++;
+                continue;
+            }
+
+            double flops = FFTRooflineFlops(length, info->transform);
+            records.push_back(FFTBatchRecord(info, length, call));
+            FFTBenchPrintTiming(label.c_str(), "call", call.timing, flops);
+            if (records.back().status != FFTBenchStatusOK) {
+                printf("%-6s call   invalid, rms error %.3g\n", label.c_str(), call.error.rms);
+                failures++;
+            }
+            if (lanes == 1) continue;
+
+            records.push_back(FFTBatchRecord(info, length, lane));
+            FFTBenchPrintTiming(label.c_str(), "lanes", lane.timing, flops);
+            printf("%-6s lanes/call %.2fx  (%ld calls x %d lanes)\n", label.c_str(),
+                   lane.timing.ns.median / call.timing.ns.median, lane.calls, lanes);
+            if (records.back().status != FFTBenchStatusOK) {
+                printf("%-6s lanes  invalid, rms error %.3g\n", label.c_str(), lane.error.rms);
+                failures++;
+            }
+        }
+    }
+
+    // measured, not extrapolated: a line fitted over the lengths crosses N = 0 wherever the cache
+    // behaviour of the larger ones puts it, below zero as often as not
+    printf("per-call overhead: ns per call at the smallest length each backend transforms correctly, "
+           "its butterflies included\n");
+    for (size_t b = 0; b < backends.size(); b++) {
+        const FFTBackendInfo *info = backends[b];
+        std::string label = std::string(info->name) + ":";
+        FFTBackend *probe = info->create();
+        for (int length = 2; length <= FFTBatchOverheadMaxLength; length *= 2) {
+            if (!probe->supports(length)) continue;
+            std::vector<double> data_real(length), data_imag(length);
+            std::vector<double> idft_real(length), idft_imag(length);
+            FFTBenchGenerateInput(data_real.data(), data_imag.data(), length);
+            FFTReferenceDFT(data_real.data(), data_imag.data(), idft_real.data(), idft_imag.data(), length, -1);
+
+            FFTBatchPath call;
+            if (!FFTBatchMeasure(info, length, transforms, 1, data_real.data(), data_imag.data(),
+                                 idft_real.data(), idft_imag.data(), options, call)) {
+                continue;
+            }
+            FFTRecord record = FFTBatchRecord(info, length, call);
+            if (record.status != FFTBenchStatusOK) continue; // e.g. ne10 at 2 points
+            record.direction = "overhead";
+            records.push_back(record);
+            printf("%-6s call   %8.1f ns  (N = %d, %.0f butterflies)\n", label.c_str(), call.timing.ns.median,
+                   length, FFTBenchButterflies(length));
+            break;
+        }
+        delete probe;
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
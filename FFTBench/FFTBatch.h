@@ -0,0 +1,37 @@
+//
+//  FFTBatch.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTBatch__
+#define __FFTBench__FFTBatch__
+
+#include "FFTBench.h"
+
+/*
+ Many independent small transforms back to back, e.g. 4096 x 64 points:
+
+    for() {
+      for (b = 0; b < B; b++) fft(b);            // call: B instances, one transform per call
+      for (c = 0; c < B / lanes; c++) fft(c);    // lanes: one transform per SIMD lane
+    }
+
+ The call path runs the plain API once per transform (instances share their
+ plan where the library allows it). Backends whose layout has several lanes
+ (nsfft, kiss-simd) are also run with every lane loaded, which is the only
+ batch interface any of the vendored libraries has. Inputs are marshalled
+ once as for the sweep's fwd/inv: in-place backends restore their buffers
+ with a memcpy, out-of-place ones run the bare forward transform.
+
+ Every lane is checked against the reference. The per-call overhead is the
+ ns of one call at the smallest power of two (2 .. 64) the backend supports
+ and transforms correctly, timed the same way: an upper bound holding that
+ length's few butterflies, recorded with direction "overhead".
+ */
+
+/// Run the batch benchmark over the lengths of options, return the number of failures.
+int FFTBatchRun(const FFTBenchOptions &options);
+
+#endif /* defined(__FFTBench__FFTBatch__) */
@@ -0,0 +1,619 @@
+//
+//  FFTBench.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBench.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+#include "FFTReference.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTAlloc.h"
+#include "nsfft.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+
+// Twiddle recurrences as in myfft reach 1e-4 at 2^20 in float.
+double FFTBenchTolerance(FFTPrecision precision) {
+    return precision == FFTPrecisionDouble ? 1e-9 : 1e-3;
+}
+
+
+void FFTBenchGenerateInput(double *data_real, double *data_imag, int length) {
+    static const double tones[4][4] = { // freq, amp, phase, dc
+        {100,   2,   M_PI / 4, -0.5},
+        {500,   1,   M_PI / 3,  1},
+        {10000, 0.5, M_PI / 2,  0},
+        {20000, 0.3, M_PI / 9,  0},
+    };
+    double rate = 44100;
+    memset(data_real, 0, length * sizeof(double));
+    memset(data_imag, 0, length * sizeof(double));
+    for (int t = 0; t < 4; t++) {
+        double freq = tones[t][0], amp = tones[t][1], phase = tones[t][2], dc = tones[t][3];
+        for (int i = 0; i < length; i++) {
+            data_real[i] += cos(i * (2 * M_PI) / (rate / freq) + phase) * amp + dc;
+        }
+    }
+}
+
+
+/// measure the error of one backend against the reference, false if beyond the tolerance
+static bool FFTBenchValidate(FFTBackend *backend, int length,
+                             const double *data_real, const double *data_imag,
+                             const double *idft_real, const double *idft_imag,
+                             FFTError &forwardError, FFTError &inverseError) {
+    FFTLayout layout = backend->layout();
+    int bins = FFTLayoutSpectrumBins(layout, length);
+    std::vector<double> real(length), imag(length);
+
+    FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+    backend->forward();
+    FFTSpectrumStore(layout, real.data(), imag.data(), length, 1.0 / layout.forwardScale);
+    forwardError = FFTErrorCompute(real.data(), imag.data(), idft_real, idft_imag, bins);
+
+    // the inverse starts from the exact spectrum, so each direction is checked on its own
+    FFTSpectrumLoad(layout, idft_real, idft_imag, length);
+    backend->inverse();
+    double scale = 1.0 / (length * layout.inverseScale);
+    FFTBufferStore(layout.input, layout.precision, real.data(), imag.data(), length, scale);
+    inverseError = FFTErrorCompute(real.data(), imag.data(), data_real, data_imag, length);
+
+    double tolerance = FFTBenchTolerance(layout.precision);
+    return forwardError.rms <= tolerance && inverseError.rms <= tolerance; // false for NaN
+}
+
+
+/*
+ Phases of one round trip, timed separately:
+
+    load     double -> library layout (the marshalling loop of FFTRun)
+    fwd      forward transform
+    inv      inverse transform
+    store    library layout -> double spectrum (unpacking real transforms)
+
+ fwd/inv time the bare transforms on input converted once: out-of-place
+ backends run the transform alone, in-place backends restore their buffer with
+ a raw memcpy. The GFLOPS and roofline figures come from these. Unless
+ premarshal, fwd+load/inv+load time the transforms again reloading their own
+ input each iteration, as in FFTRun. Hardware counters, when open, count
+ exactly the timed fwd/inv loops; energy counters run the same bare loops
+ again for FFTEnergySeconds, so joules per point never include the reload.
+ */
+struct FFTBenchPhases {
+    FFTTiming load;
+    FFTTiming forward;
+    FFTTiming inverse;
+    FFTTiming store;
+    FFTTiming forwardReload;    ///< forward with its input reloaded, ns.count == 0 with premarshal
+    FFTTiming inverseReload;
+    FFTCounterSample forwardCounters;
+    FFTCounterSample inverseCounters;
+    FFTEnergySample forwardEnergy;
+    FFTEnergySample inverseEnergy;
+};
+
+static FFTBenchPhases FFTBenchMeasurePhases(FFTBackend *backend, int length,
+                                            const double *data_real, const double *data_imag,
+                                            const double *idft_real, const double *idft_imag,
+                                            const FFTBenchOptions &options, FFTCounters *counters,
+                                            FFTEnergy *energy) {
+    FFTLayout layout = backend->layout();
+    bool inPlace = FFTLayoutIsInPlace(layout);
+    long batch = options.points / length / options.timer.trials;
+    FFTTimerOptions timer = options.timer;
+    if (batch < 1 && timer.budget <= 0) timer.budget = FFTBenchLargeBudget; // fewer points than trials
+    std::vector<double> real(length), imag(length);
+    FFTBenchPhases phases = FFTBenchPhases();
+
+    phases.load = FFTTimerMeasure(timer, batch, [&](long n) {
+        for (long r = 0; r < n; r++) {
+            FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+        }
+    });
+
+    FFTBufferImage image;
+    FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+    image.capture(layout.input, layout.precision, length);
+    auto forward = [&](long n) {
+        for (long r = 0; r < n; r++) {
+            if (inPlace) image.restore();
+            backend->forward();
+        }
+    };
+    phases.forward = FFTTimerMeasure(timer, batch, forward);
+    if (counters) phases.forwardCounters = FFTCountersMeasure(*counters, batch, forward);
+    if (energy) phases.forwardEnergy = FFTEnergyMeasure(*energy, batch, forward);
+    if (!options.premarshal) {
+        phases.forwardReload = FFTTimerMeasure(timer, batch, [&](long n) {
+            for (long r = 0; r < n; r++) {
+                FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+                backend->forward();
+            }
+        });
+    }
+
+    FFTSpectrumLoad(layout, idft_real, idft_imag, length);
+    image.capture(layout.output, layout.precision, FFTLayoutSpectrumSlots(layout, length));
+    auto inverse = [&](long n) {
+        for (long r = 0; r < n; r++) {
+            if (inPlace) image.restore();
+            backend->inverse();
+        }
+    };
+    phases.inverse = FFTTimerMeasure(timer, batch, inverse);
+    if (counters) phases.inverseCounters = FFTCountersMeasure(*counters, batch, inverse);
+    if (energy) phases.inverseEnergy = FFTEnergyMeasure(*energy, batch, inverse);
+    if (!options.premarshal) {
+        phases.inverseReload = FFTTimerMeasure(timer, batch, [&](long n) {
+            for (long r = 0; r < n; r++) {
+                FFTSpectrumLoad(layout, idft_real, idft_imag, length);
+                backend->inverse();
+            }
+        });
+    }
+
+    phases.store = FFTTimerMeasure(timer, batch, [&](long n) {
+        for (long r = 0; r < n; r++) {
+            FFTSpectrumStore(layout, real.data(), imag.data(), length, 1);
+        }
+    });
+    return phases;
+}
+
+
+void FFTBenchPrintTiming(const char *label, const char *direction, const FFTTiming &timing, double flops) {
+    const FFTStats &ns = timing.ns;
+    printf("%-6s %-5s  min %9.1f  med %9.1f  p90 %9.1f  p99 %9.1f ns  ci95 [%.1f, %.1f]",
+           label, direction, ns.min, ns.median, ns.p90, ns.p99, ns.ciLow, ns.ciHigh);
+    if (flops > 0) printf("  %7.2f GFLOPS", flops / ns.median);
+    if (timing.cycles.count) printf("  %9.0f cyc", timing.cycles.median);
+    printf("\n");
+}
+
+
+/// setup() with the heap counted, `plan` being what the library's plan constructors took of it
+static bool FFTBenchSetup(FFTBackend *backend, int length, FFTPlanCost &plan) {
+    FFTPlanReset();
+    FFTAllocTrack(true);
+    bool ready = backend->setup(length);
+    FFTAllocTrack(false);
+    plan = FFTPlanRead();
+    return ready;
+}
+
+static void FFTBenchRoundtrip(void *context) {
+    FFTBackend *backend = (FFTBackend *)context;
+    backend->forward();
+    backend->inverse();
+}
+
+/// Transient heap and stack of one forward+inverse pair, after the timed runs.
+static void FFTBenchMeasureMemory(FFTBackend *backend, FFTBenchResult &result) {
+    FFTAllocTrack(true);
+    FFTAllocResetPeak();
+    FFTAllocCount before = FFTAllocRead();
+    FFTBenchRoundtrip(backend);
+    FFTAllocCount after = FFTAllocRead();
+    FFTAllocTrack(false);
+
+    bool counted = FFTAllocAvailable();
+    result.hasMemory = true;
+    result.peakBytes = counted ? after.peak - before.live : -1;
+    result.allocsPerCall = counted ? (double)(after.calls - before.calls) : 0;
+    result.stackBytes = FFTAllocStackUse(FFTBenchRoundtrip, backend);
+}
+
+static void FFTBenchPrintMemory(const char *label, const FFTBenchResult &result) {
+    printf("%-6s mem   ", label);
+    if (result.setupBytes >= 0) {
+        printf("  plan %.1f KB  buffers %.1f KB  call peak %.1f KB  allocs/call %.0f", result.planBytes / 1024.0,
+               (result.setupBytes - result.planBytes) / 1024.0, result.peakBytes / 1024.0, result.allocsPerCall);
+    } else {
+        printf("  heap not counted in this build");
+    }
+    if (result.stackBytes >= 0) printf("  stack %.1f KB", result.stackBytes / 1024.0);
+    printf("\n");
+}
+
+
+/// counters per point, and per radix-2 butterfly equivalent (N/2 log2 N)
+static void FFTBenchPrintCounters(const char *label, const char *direction, const FFTCounterSample &sample,
+                                  int length) {
+    const double *v = sample.values;
+    double butterflies = FFTBenchButterflies(length);
+    char text[FFTCounterCount][16];
+    for (int i = 0; i < FFTCounterCount; i++) {
+        double per = (i == FFTCounterCycles || i == FFTCounterInstructions) ? length : butterflies;
+        if (v[i] < 0) snprintf(text[i], sizeof(text[i]), "-");
+        else snprintf(text[i], sizeof(text[i]), "%.3g", v[i] / per);
+    }
+    char ipc[16] = "-";
+    if (v[FFTCounterCycles] > 0 && v[FFTCounterInstructions] >= 0) {
+        snprintf(ipc, sizeof(ipc), "%.2f", v[FFTCounterInstructions] / v[FFTCounterCycles]);
+    }
+    printf("%-6s %-5s  cyc/pt %s  ins/pt %s  ipc %s  per butterfly: l1d %s  llc %s  br %s  dtlb %s\n",
+           label, direction, text[FFTCounterCycles], text[FFTCounterInstructions], ipc,
+           text[FFTCounterL1DMisses], text[FFTCounterLLCMisses], text[FFTCounterBranchMisses],
+           text[FFTCounterDTLBMisses]);
+}
+
+
+/// joules per million points of each domain, and the mean power of the run
+static void FFTBenchPrintEnergy(const char *label, const char *direction, const FFTEnergySample &sample,
+                                int length) {
+    char text[FFTEnergyDomainCount][16];
+    double watts = 0;
+    for (int d = 0; d < FFTEnergyDomainCount; d++) {
+        if (sample.joules[d] < 0) {
+            snprintf(text[d], sizeof(text[d]), "-");
+            continue;
+        }
+        snprintf(text[d], sizeof(text[d]), "%.4g", sample.joules[d] / length * 1e6);
+        if (sample.seconds > 0) watts += sample.joules[d] / sample.seconds;
+    }
+    printf("%-6s %-5s  J/Mpt package %s  dram %s  (%.1f W)\n", label, direction, text[FFTEnergyPackage],
+           text[FFTEnergyDRAM], watts);
+}
+
+
+/// Free physical memory, 0 if unknown.
+static size_t FFTBenchMemoryAvailable(void) {
+#if defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+    long pages = sysconf(_SC_AVPHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0) return (size_t)pages * (size_t)pageSize;
+#endif
+    return 0;
+}
+
+static size_t FFTBenchMemoryLimit(const FFTBenchOptions &options) {
+    return options.memoryLimit ? options.memoryLimit : FFTBenchMemoryAvailable();
+}
+
+/// The harness's own arrays for one length: six double vectors and the long double reference,
+/// which keeps the signal and its twiddles, and for Bluestein two padded sequences plus their twiddles.
+static long long FFTBenchHarnessBytes(int length) {
+    long long complexL = 2 * sizeof(long double);
+    long long bytes = (long long)length * 6 * sizeof(double) + 2LL * length * complexL;
+    if (!FFTSizeIsPow2(length)) {
+        long long m = 1;
+        while (m < 2LL * length - 1) m <<= 1;
+        bytes += 3 * m * complexL;
+    }
+    return bytes;
+}
+
+/// Heap a setup of `length` points is expected to keep: the last measured setup of the backend
+/// scaled linearly, before that a guess of eight complex samples per point.
+static long long FFTBenchSetupEstimate(const FFTBackendInfo *info, int length,
+                                       const std::vector<FFTBenchResult> &results) {
+    for (size_t i = results.size(); i-- > 0; ) {
+        const FFTBenchResult &result = results[i];
+        if (result.backend != info->name || result.setupBytes <= 0) continue;
+        return (long long)((double)result.setupBytes / result.length * length);
+    }
+    long long scalar = info->precision == FFTPrecisionDouble ? sizeof(double) : sizeof(float);
+    return (long long)length * 2 * scalar * 8;
+}
+
+
+static int FFTBenchRunLength(const std::vector<const FFTBackendInfo *> &backends, int length,
+                             const FFTBenchOptions &options, FFTCounters *counters, FFTEnergy *energy,
+                             std::vector<FFTBenchResult> &results) {
+    printf("%d-------\n", length);
+    int failures = 0;
+
+    size_t limit = FFTBenchMemoryLimit(options);
+    long long harness = FFTBenchHarnessBytes(length);
+    if (limit && harness > (long long)limit) {
+        printf("skipped: input and reference arrays need ~%.0f MB, %.0f MB available\n", harness / 1048576.0,
+               limit / 1048576.0);
+        for (size_t b = 0; b < backends.size(); b++) {
+            FFTBenchResult result = FFTBenchResult();
+            result.backend = backends[b]->name;
+            result.length = length;
+            result.precision = backends[b]->precision;
+            result.transform = backends[b]->transform;
+            result.status = FFTBenchStatusMemoryLimit;
+            results.push_back(result);
+        }
+        return 0;
+    }
+
+    std::vector<double> data_real(length), data_imag(length);
+    std::vector<double> idft_real(length), idft_imag(length);
+    FFTSignalGenerate(options.signal, options.transform, options.precision, data_real.data(), data_imag.data(),
+                      length);
+    FFTReferenceDFT(data_real.data(), data_imag.data(), idft_real.data(), idft_imag.data(), length, -1);
+
+    for (size_t b = 0; b < backends.size(); b++) {
+        const FFTBackendInfo *info = backends[b];
+        std::string label = std::string(info->name) + ":";
+        FFTBackend *backend = info->create();
+        FFTBenchResult result = FFTBenchResult();
+        result.backend = info->name;
+        result.length = length;
+        result.precision = info->precision;
+        result.transform = info->transform;
+        result.status = FFTBenchStatusOK;
+
+        FFTAllocCount heap = FFTAllocRead();
+        FFTPlanCost plan = FFTPlanCost();
+        long long estimate = FFTBenchSetupEstimate(info, length, results);
+        if (!backend->supports(length)) {
+            result.status = FFTBenchStatusUnsupported;
+        } else if (limit && estimate > (long long)(limit - std::min((size_t)harness, limit))) {
+            printf("%-6s skipped: setup needs ~%.0f MB, %.0f MB left\n", label.c_str(), estimate / 1048576.0,
+                   (limit - std::min((size_t)harness, limit)) / 1048576.0);
+            result.status = FFTBenchStatusMemoryLimit;
+        } else if (!FFTBenchSetup(backend, length, plan)) {
+            printf("%-6s setup failed\n", label.c_str());
+            backend->teardown();
+            result.status = FFTBenchStatusSetupFailed;
+            failures++;
+        } else {
+            result.inPlace = FFTLayoutIsInPlace(backend->layout());
+            FFTAllocTrack(true); // the first transforms may still allocate (fftn's scratch)
+            bool valid = FFTBenchValidate(backend, length, data_real.data(), data_imag.data(),
+                                          idft_real.data(), idft_imag.data(),
+                                          result.forwardError, result.inverseError);
+            FFTAllocTrack(false);
+            result.setupBytes = FFTAllocAvailable() ? FFTAllocRead().live - heap.live : -1;
+            result.planBytes = FFTAllocAvailable() ? plan.bytes : -1;
+            printf("%-6s err    fwd rms %.2e max %.2e  inv rms %.2e max %.2e%s\n", label.c_str(),
+                   result.forwardError.rms, result.forwardError.max,
+                   result.inverseError.rms, result.inverseError.max, valid ? "" : "  data err!");
+            if (!valid) {
+                result.status = FFTBenchStatusInvalid;
+                failures++;
+            }
+
+            FFTBenchPhases phases = FFTBenchMeasurePhases(backend, length, data_real.data(), data_imag.data(),
+                                                          idft_real.data(), idft_imag.data(), options, counters,
+                                                          energy);
+            double flops = FFTRooflineFlops(length, info->transform);
+            FFTBenchPrintTiming(label.c_str(), "load", phases.load, 0);
+            FFTBenchPrintTiming(label.c_str(), "fwd", phases.forward, flops);
+            FFTBenchPrintTiming(label.c_str(), "inv", phases.inverse, flops);
+            if (!options.premarshal) {
+                FFTBenchPrintTiming(label.c_str(), "fwd+load", phases.forwardReload, 0);
+                FFTBenchPrintTiming(label.c_str(), "inv+load", phases.inverseReload, 0);
+            }
+            FFTBenchPrintTiming(label.c_str(), "store", phases.store, 0);
+            if (counters) {
+                FFTBenchPrintCounters(label.c_str(), "fwd", phases.forwardCounters, length);
+                FFTBenchPrintCounters(label.c_str(), "inv", phases.inverseCounters, length);
+            }
+            if (energy) {
+                FFTBenchPrintEnergy(label.c_str(), "fwd", phases.forwardEnergy, length);
+                FFTBenchPrintEnergy(label.c_str(), "inv", phases.inverseEnergy, length);
+            }
+            result.load = phases.load;
+            result.forward = phases.forward;
+            result.inverse = phases.inverse;
+            result.store = phases.store;
+            result.forwardReload = phases.forwardReload;
+            result.inverseReload = phases.inverseReload;
+            result.hasCounters = (counters != NULL);
+            result.forwardCounters = phases.forwardCounters;
+            result.inverseCounters = phases.inverseCounters;
+            result.hasEnergy = (energy != NULL);
+            result.forwardEnergy = phases.forwardEnergy;
+            result.inverseEnergy = phases.inverseEnergy;
+            FFTBenchMeasureMemory(backend, result);
+            FFTBenchPrintMemory(label.c_str(), result);
+            backend->teardown();
+        }
+
+        results.push_back(result);
+        delete backend;
+    }
+    return failures;
+}
+
+
+static double FFTBenchForwardNanoseconds(const FFTBenchResult &result) {
+    return result.forward.ns.median;
+}
+
+static double FFTBenchForwardReloadNanoseconds(const FFTBenchResult &result) {
+    return result.forwardReload.ns.median;
+}
+
+static double FFTBenchForwardGflops(const FFTBenchResult &result) {
+    return FFTRooflineFlops(result.length, result.transform) / result.forward.ns.median;
+}
+
+/// percent of the attainable rate at the arithmetic intensity of the cell
+static double FFTBenchForwardRoofline(const FFTBenchResult &result) {
+    const FFTRoofline &roofline = FFTRooflineMeasure(result.precision);
+    return FFTBenchForwardGflops(result) * 100 /
+           FFTRooflineBound(roofline, result.length, result.transform, result.precision);
+}
+
+static double FFTBenchPlanKilobytes(const FFTBenchResult &result) {
+    return result.planBytes / 1024.0;
+}
+
+static double FFTBenchBufferKilobytes(const FFTBenchResult &result) {
+    return (result.setupBytes - result.planBytes) / 1024.0;
+}
+
+static double FFTBenchForwardJoules(const FFTBenchResult &result) {
+    return result.forwardEnergy.joules[FFTEnergyPackage] / result.length * 1e6;
+}
+
+/// capability-and-speed matrix: one value per (length, backend)
+static void FFTBenchPrintMatrix(const std::vector<const FFTBackendInfo *> &backends,
+                                const std::vector<FFTBenchResult> &results, const char *title,
+                                double (*value)(const FFTBenchResult &), int decimals) {
+    printf("\n%s  (- unsupported, fail setup failed, mem over memory limit, ! wrong result)\n", title);
+    std::vector<int> widths(backends.size());
+    printf("%8s", "length");
+    for (size_t b = 0; b < backends.size(); b++) {
+        widths[b] = std::max(10, (int)strlen(backends[b]->name));
+        printf(" %*s", widths[b], backends[b]->name);
+    }
+    printf("\n");
+
+    for (size_t r = 0; r < results.size(); r += backends.size()) {
+        printf("%8d", results[r].length);
+        for (size_t b = 0; b < backends.size(); b++) {
+            const FFTBenchResult &result = results[r + b];
+            char cell[32];
+            switch (result.status) {
+                case FFTBenchStatusUnsupported: snprintf(cell, sizeof(cell), "-"); break;
+                case FFTBenchStatusSetupFailed: snprintf(cell, sizeof(cell), "fail"); break;
+                case FFTBenchStatusMemoryLimit: snprintf(cell, sizeof(cell), "mem"); break;
+                case FFTBenchStatusInvalid: snprintf(cell, sizeof(cell), "%.*f!", decimals, value(result)); break;
+                default: snprintf(cell, sizeof(cell), "%.*f", decimals, value(result)); break;
+            }
+            printf(" %*s", widths[b], cell);
+        }
+        printf("\n");
+    }
+}
+
+
+double FFTBenchButterflies(int length) {
+    return length > 1 ? length / 2.0 * log2((double)length) : 1;
+}
+
+
+std::vector<int> FFTBenchLengths(const FFTBenchOptions &options) {
+    if (!options.lengths.empty()) return options.lengths;
+    return FFTSizesGenerate(options.sizeSet, 1 << options.minLog2, 1 << options.maxLog2);
+}
+
+
+bool FFTBenchSelectBackends(const FFTBenchOptions &options, std::vector<const FFTBackendInfo *> &backends) {
+    backends.clear();
+    if (options.backends.empty()) {
+        const std::vector<FFTBackendInfo> &all = FFTBackendRegistry::backends();
+        for (size_t i = 0; i < all.size(); i++) {
+            if (all[i].transform != options.transform || all[i].precision != options.precision) continue;
+            if (all[i].optIn) continue;
+            backends.push_back(&all[i]);
+        }
+        return true;
+    }
+    for (size_t i = 0; i < options.backends.size(); i++) {
+        const FFTBackendInfo *info = FFTBackendRegistry::find(options.backends[i].c_str());
+        if (!info) {
+            fprintf(stderr, "unknown backend: %s\n", options.backends[i].c_str());
+            return false;
+        }
+        backends.push_back(info);
+    }
+    return true;
+}
+
+
+const char *FFTBenchArchitecture(void) {
+#if defined(__aarch64__)
+    return "arm64";
+#elif defined(__arm__)
+    return "armv7";
+#elif ULONG_MAX > 0xFFFFFFFF
+    return "x86_64";
+#else
+    return "i386";
+#endif
+}
+
+
+void FFTBenchPrintEnvironment(void) {
+    printf("run fft in %s\n", FFTBenchArchitecture());
+    printf("----------------\n");
+}
+
+
+int FFTBenchRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    FFTBenchPrintEnvironment();
+
+    FFTCounters counters;
+    if (options.counters && !counters.open()) {
+        fprintf(stderr, "hardware counters not available: %s\n", counters.error());
+    }
+    FFTEnergy energy;
+    if (options.energy && !energy.open()) {
+        fprintf(stderr, "energy counters not available: %s\n", energy.error());
+    }
+    if (options.roofline) {
+        const FFTRoofline &roofline = FFTRooflineMeasure(options.precision);
+        printf("roofline: peak %.1f GFLOPS (%s)  bandwidth l1 %.1f  cache %.1f  dram %.1f GB/s\n", roofline.gflops,
+               roofline.isa, roofline.l1, roofline.cache, roofline.dram);
+    }
+    bool flushed = false;
+    if (options.flushDenormals && !FFTSignalCanFlushDenormals()) {
+        fprintf(stderr, "FTZ/DAZ not available on this cpu, running without\n");
+    } else if (options.flushDenormals) {
+        flushed = FFTSignalSetFlushDenormals(true);
+    }
+    if (options.signal != FFTSignalCosines || options.flushDenormals) {
+        printf("input: %s%s\n", FFTSignalName(options.signal), options.flushDenormals ? ", FTZ/DAZ on" : "");
+    }
+
+    int failures = 0;
+    std::vector<FFTBenchResult> results;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    int cache = SIMDBase_sizeOfDataCacheInByte();
+    size_t sample = 2 * (options.precision == FFTPrecisionDouble ? sizeof(double) : sizeof(float));
+    for (size_t i = 0; i < lengths.size(); i++) {
+        if (cache <= 0 || (long long)lengths[i] * (long long)sample <= (long long)cache) continue;
+        printf("lengths from %d points exceed the %.1f MB data cache\n", lengths[i], cache / 1048576.0);
+        break;
+    }
+    for (size_t i = 0; i < lengths.size(); i++) {
+        failures += FFTBenchRunLength(backends, lengths[i], options, counters.isOpen() ? &counters : NULL,
+                                      energy.isOpen() ? &energy : NULL, results);
+    }
+    if (options.flushDenormals && FFTSignalCanFlushDenormals()) FFTSignalSetFlushDenormals(flushed);
+    FFTBenchPrintMatrix(backends, results, "forward median ns", FFTBenchForwardNanoseconds, 0);
+    if (!options.premarshal) {
+        FFTBenchPrintMatrix(backends, results, "forward median ns reloading the input (FFTRun)",
+                            FFTBenchForwardReloadNanoseconds, 0);
+    }
+    FFTBenchPrintMatrix(backends, results, "forward GFLOPS (5 N log2 N, real 2.5 N log2 N)", FFTBenchForwardGflops, 2);
+    if (options.roofline) {
+        FFTBenchPrintMatrix(backends, results, "forward % of the roofline bound", FFTBenchForwardRoofline, 0);
+    }
+    if (FFTAllocAvailable()) {
+        FFTBenchPrintMatrix(backends, results, "plan heap KB (library plan constructors)", FFTBenchPlanKilobytes, 1);
+        FFTBenchPrintMatrix(backends, results, "buffer heap KB (backend I/O buffers, first-call scratch)",
+                            FFTBenchBufferKilobytes, 1);
+    }
+    if (energy.isOpen()) {
+        FFTBenchPrintMatrix(backends, results, "forward package J per Mpoint (bare transform)",
+                            FFTBenchForwardJoules, 3);
+    }
+
+    std::vector<FFTRecord> records;
+    FFTReportAddResults(results, records);
+    if (options.signal != FFTSignalCosines || options.flushDenormals) {
+        for (size_t i = 0; i < records.size(); i++) {
+            records[i].signal = FFTSignalName(options.signal);
+            records[i].flushDenormals = options.flushDenormals;
+        }
+    }
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
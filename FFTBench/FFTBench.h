@@ -0,0 +1,172 @@
+//
+//  FFTBench.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTBench__
+#define __FFTBench__FFTBench__
+
+#include "FFTTimer.h"
+#include "FFTSizes.h"
+#include "FFTBackend.h"
+#include "FFTReference.h"
+#include "FFTCounters.h"
+#include "FFTEnergy.h"
+#include "FFTSignal.h"
+#include "FFTRoofline.h"
+
+#include <string>
+#include <vector>
+
+/*
+ Portable port of -[FFTRun run]: for every length and every registered backend
+
+    for() {
+      input();
+      fft();
+      ifft();
+    }
+ */
+
+/// largest --max-log2: 2^24 points still validate in seconds, and 16M-point plans fit in RAM
+#define FFTBenchMaxLog2 24
+
+/// seconds per measurement of lengths beyond options.points / trials, when no --budget is given
+#define FFTBenchLargeBudget 1.0
+
+struct FFTBenchOptions {
+    std::vector<std::string> backends;  ///< empty: all registered backends of `transform`
+    FFTTransform transform;             ///< complex (c2c) or real (r2c/c2r) track
+    FFTPrecision precision;             ///< single or double precision track
+    int minLog2;                        ///< lengths start at 2^minLog2
+    int maxLog2;                        ///< lengths end at 2^maxLog2
+    FFTSizeSet sizeSet;                 ///< lengths between the two bounds
+    std::vector<int> lengths;           ///< explicit lengths, override the size set
+    long points;                        ///< points transformed per (backend, length, direction)
+    bool premarshal;                    ///< skip timing fwd/inv again with their input reloaded
+    FFTSignal signal;                   ///< input of the sweep
+    bool flushDenormals;                ///< run the sweep with FTZ/DAZ on
+    FFTTimerOptions timer;
+    bool counters;                      ///< also read hardware counters of fwd/inv (Linux perf)
+    bool energy;                        ///< also read RAPL package/dram energy of fwd/inv (Linux powercap)
+    bool roofline;                      ///< measure peak flops and bandwidth, rate every cell against them
+    size_t memoryLimit;                 ///< lengths/backends expected to need more are skipped, 0: free RAM
+
+    std::vector<int> threads;           ///< thread counts of the throughput benchmark, empty: not run
+    bool sharedSetup;                   ///< threads share one plan where the library allows it
+    bool pinThreads;                    ///< pin thread i to cpu i
+    double seconds;                     ///< duration of one throughput measurement
+
+    bool cold;                          ///< run the hot/cold cache comparison instead of the sweep
+    size_t coldPoolBytes;               ///< working set of the cold instances, 0: twice the data caches
+    bool flushCache;                    ///< cold mode also times single calls after a cache flush
+
+    bool latency;                       ///< run the per-call latency benchmark instead of the sweep
+    long latencyCalls;                  ///< timed calls per (backend, length), 0: 100000
+
+    bool setupCost;                     ///< run the setup/teardown benchmark instead of the sweep
+
+    bool batch;                         ///< run the batched small-transform benchmark instead of the sweep
+    long batchTransforms;               ///< independent transforms per pass, 0: 4096
+
+    bool alignment;                     ///< run the buffer offset/aliasing benchmark instead of the sweep
+
+    bool denormals;                     ///< run the input class x FTZ/DAZ benchmark instead of the sweep
+
+    bool kernels;                       ///< time the vendored butterfly kernels alone instead of the sweep
+
+    bool stages;                        ///< split forward time by region inside the libraries (FFTStages.h)
+
+    bool isolate;                       ///< run each (backend, length) of the sweep in its own process
+    int isolateRounds;                  ///< randomized rounds over all cells, 0: 5
+    int isolateCpu;                     ///< core of the isolated children, -1: last isolcpus (or online) cpu
+
+    std::string jsonPath;               ///< write the records as json, empty: no file
+    std::string csvPath;                ///< write the records as csv, empty: no file
+    std::string baselinePath;           ///< compare against this baseline (directory or .csv), empty: no gate
+    std::string saveBaselinePath;       ///< save the records as baseline there, empty: not saved
+    double regressionThreshold;         ///< percent a median must move to count, besides disjoint ci95
+
+    FFTBenchOptions() : transform(FFTTransformComplex), precision(FFTPrecisionFloat),
+                        minLog2(4), maxLog2(15), sizeSet(FFTSizeSetPow2), points(16777216), premarshal(false),
+                        signal(FFTSignalCosines), flushDenormals(false),
+                        counters(false), energy(false), roofline(false), memoryLimit(0),
+                        sharedSetup(false), pinThreads(false), seconds(0.5),
+                        cold(false), coldPoolBytes(0), flushCache(false),
+                        latency(false), latencyCalls(0), setupCost(false),
+                        batch(false), batchTransforms(0), alignment(false), denormals(false), kernels(false),
+                        stages(false), isolate(false), isolateRounds(0), isolateCpu(-1),
+                        regressionThreshold(10) {}
+};
+
+typedef enum {
+    FFTBenchStatusOK,
+    FFTBenchStatusUnsupported,   ///< backend->supports(length) is false
+    FFTBenchStatusSetupFailed,
+    FFTBenchStatusInvalid,       ///< timed, but the error against the reference is beyond tolerance
+    FFTBenchStatusMemoryLimit,   ///< skipped, the setup is expected to exceed options.memoryLimit
+} FFTBenchStatus;
+
+/// One (backend, length) cell of the sweep.
+struct FFTBenchResult {
+    std::string backend;
+    int length;
+    FFTPrecision precision;
+    FFTTransform transform;
+    bool inPlace;
+    FFTBenchStatus status;
+    FFTError forwardError;       ///< against the long double reference
+    FFTError inverseError;
+    FFTTiming load;
+    FFTTiming forward;
+    FFTTiming inverse;
+    FFTTiming store;
+    FFTTiming forwardReload;     ///< forward reloading its input each time, ns.count == 0 with --premarshal
+    FFTTiming inverseReload;
+    bool hasCounters;
+    FFTCounterSample forwardCounters;   ///< per transform
+    FFTCounterSample inverseCounters;
+    bool hasEnergy;
+    FFTEnergySample forwardEnergy;      ///< per transform
+    FFTEnergySample inverseEnergy;
+    bool hasMemory;
+    long long setupBytes;        ///< heap kept by setup() and the first transforms (FFTAlloc), -1: not counted
+    long long planBytes;         ///< of those, kept by the library's plan constructors (FFTPlanScope)
+    long long peakBytes;         ///< transient heap peak of one forward+inverse pair, -1: not counted
+    double allocsPerCall;        ///< heap allocations of one forward+inverse pair
+    long stackBytes;             ///< stack of one forward+inverse pair, -1: not measured
+};
+
+/// Run the sweep, return the number of setup and validation failures.
+int FFTBenchRun(const FFTBenchOptions &options);
+
+/// Radix-2 butterfly equivalents of a transform, N/2 log2 N, to normalize counters of any length.
+double FFTBenchButterflies(int length);
+
+/// Largest relative rms error accepted: catches wrong results (sign, scale, packing), not imprecision,
+/// the rms/max error is printed for that.
+double FFTBenchTolerance(FFTPrecision precision);
+
+/// Lengths to run: options.lengths, or the size set between the log2 bounds.
+std::vector<int> FFTBenchLengths(const FFTBenchOptions &options);
+
+/// Backends named in options (all of the options.transform/precision track if none,
+/// without the opt-in ones), false if a name is unknown.
+bool FFTBenchSelectBackends(const FFTBenchOptions &options, std::vector<const FFTBackendInfo *> &backends);
+
+/// One "label direction  min med p90 p99 ci95 GFLOPS" line, `flops` nominal per timed call
+/// (FFTRooflineFlops; 0 for the load/store phases, which print no rate).
+void FFTBenchPrintTiming(const char *label, const char *direction, const FFTTiming &timing, double flops);
+
+/// "x86_64", "arm64", ...
+const char *FFTBenchArchitecture(void);
+
+/// "run fft in x86_64" header.
+void FFTBenchPrintEnvironment(void);
+
+/// The four-tone audio mix of the original FFTRun.
+void FFTBenchGenerateInput(double *data_real, double *data_imag, int length);
+
+#endif /* defined(__FFTBench__FFTBench__) */
@@ -0,0 +1,219 @@
+//
+//  FFTColdCache.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTColdCache.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+#include "nsfft.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define FFTColdCacheMaxSlots (1 << 16)
+#define FFTColdCacheLine 64
+
+
+/// L2 + L3 on x86 (SIMDBase), 8 MB if unknown.
+static size_t FFTColdCacheDataBytes(void) {
+    int bytes = SIMDBase_sizeOfDataCacheInByte();
+    return bytes > 0 ? (size_t)bytes : ((size_t)8 << 20);
+}
+
+void FFTColdCacheFlush(void) {
+    static std::vector<unsigned char> buffer(FFTColdCacheDataBytes() / 2 * 3);
+    volatile unsigned char *p = buffer.data();
+    size_t size = buffer.size();
+    for (size_t i = 0; i < size; i += FFTColdCacheLine) p[i]++; // dirty lines, so none can stay clean-shared
+}
+
+
+/// One independent instance: plan, backend buffers and its own copy of the input.
+struct FFTColdCacheSlot {
+    FFTBackend *backend;
+    FFTLayout layout;
+    std::vector<double> real;
+    std::vector<double> imag;
+};
+
+static inline void FFTColdCacheRoundtrip(const FFTColdCacheSlot &slot, int length) {
+    FFTBufferLoad(slot.layout.input, slot.layout.precision, slot.real.data(),
+                  slot.imag.empty() ? NULL : slot.imag.data(), length);
+    slot.backend->forward();
+    slot.backend->inverse();
+}
+
+/// Estimated bytes one slot touches: input and output buffers, its input copy,
+/// and a plan of the size of one buffer (twiddles). Libraries keep more than that.
+static size_t FFTColdCacheSlotBytes(const FFTLayout &layout, int length) {
+    size_t scalar = layout.precision == FFTPrecisionDouble ? sizeof(double) : sizeof(float);
+    size_t input = (size_t)length * scalar * (layout.input.imag ? 2 : 1);
+    size_t output = FFTLayoutIsInPlace(layout) ? 0 : (size_t)FFTLayoutSpectrumSlots(layout, length) * scalar * 2;
+    size_t source = (size_t)length * sizeof(double) * (layout.input.imag ? 2 : 1);
+    return input * 2 + output + source;
+}
+
+static void FFTColdCacheRelease(std::vector<FFTColdCacheSlot> &slots) {
+    for (size_t i = slots.size(); i > 0; i--) {
+        slots[i - 1].backend->teardown();
+        delete slots[i - 1].backend;
+    }
+    slots.clear();
+}
+
+/// Pool of independent instances filling `poolBytes`, false if one could not be set up.
+static bool FFTColdCacheSetup(const FFTBackendInfo *info, int length, size_t poolBytes,
+                              const double *data_real, const double *data_imag,
+                              std::vector<FFTColdCacheSlot> &slots) {
+    size_t count = 1;
+    for (size_t i = 0; i < count; i++) {
+        FFTColdCacheSlot slot;
+        slot.backend = info->create();
+        if (!slot.backend->setup(length)) {
+            slot.backend->teardown();
+            delete slot.backend;
+            FFTColdCacheRelease(slots);
+            return false;
+        }
+        slot.layout = slot.backend->layout();
+        slot.real.assign(data_real, data_real + length);
+        if (slot.layout.input.imag) slot.imag.assign(data_imag, data_imag + length);
+        if (i == 0) {
+            size_t bytes = FFTColdCacheSlotBytes(slot.layout, length);
+            count = (poolBytes + bytes - 1) / bytes;
+            if (count < 2) count = 2;
+            if (count > FFTColdCacheMaxSlots) count = FFTColdCacheMaxSlots;
+            slots.reserve(count);
+        }
+        slots.push_back(slot);
+    }
+    return true;
+}
+
+
+/// Single calls, each after a cache flush.
+static FFTTiming FFTColdCacheMeasureFlushed(const FFTBenchOptions &options,
+                                            const std::vector<FFTColdCacheSlot> &slots, int length) {
+    int trials = options.timer.trials > 0 ? options.timer.trials : 1;
+    bool cycles = options.timer.cycles && FFTTimerHasCycles();
+    std::vector<double> ns(trials), cy(cycles ? trials : 0);
+    for (int t = 0; t < trials; t++) {
+        const FFTColdCacheSlot &slot = slots[t % slots.size()];
+        FFTColdCacheFlush();
+        uint64_t c0 = cycles ? FFTTimerCycles() : 0;
+        uint64_t t0 = FFTTimerNanoseconds();
+        FFTColdCacheRoundtrip(slot, length);
+        uint64_t t1 = FFTTimerNanoseconds();
+        uint64_t c1 = cycles ? FFTTimerCycles() : 0;
+        ns[t] = (double)(t1 - t0);
+        if (cycles) cy[t] = (double)(c1 - c0);
+    }
+    FFTTiming timing;
+    timing.batch = 1;
+    timing.ns = FFTStatsCompute(ns);
+    timing.cycles = FFTStatsCompute(cy);
+    return timing;
+}
+
+
+static FFTRecord FFTColdCacheRecord(const FFTBackendInfo *info, int length, bool inPlace, const char *cache) {
+    FFTRecord record = FFTRecord();
+    record.backend = info->name;
+    record.length = length;
+    record.precision = info->precision;
+    record.transform = info->transform;
+    record.inPlace = inPlace;
+    record.direction = "roundtrip";
+    record.cache = cache;
+    record.threads = 1;
+    record.status = FFTBenchStatusOK;
+    return record;
+}
+
+
+int FFTColdCacheRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    size_t poolBytes = options.coldPoolBytes ? options.coldPoolBytes : FFTColdCacheDataBytes() * 2;
+    FFTBenchPrintEnvironment();
+    printf("cold cache: %.1f MB pool, data caches %.1f MB%s\n", poolBytes / 1048576.0,
+           FFTColdCacheDataBytes() / 1048576.0, options.flushCache ? ", flushed calls" : "");
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        int length = lengths[l];
+        printf("%d-------\n", length);
+
+        std::vector<double> data_real(length), data_imag(length);
+        FFTBenchGenerateInput(data_real.data(), data_imag.data(), length);
+        long batch = options.points / length / options.timer.trials;
+        FFTTimerOptions timer = options.timer;
+        if (batch < 1 && timer.budget <= 0) timer.budget = FFTBenchLargeBudget; // fewer points than trials
+
+        for (size_t b = 0; b < backends.size(); b++) {
+            const FFTBackendInfo *info = backends[b];
+            std::string label = std::string(info->name) + ":";
+            FFTBackend *probe = info->create();
+            bool supported = probe->supports(length);
+            delete probe;
+            if (!supported) continue;
+
+            std::vector<FFTColdCacheSlot> slots;
+            if (!FFTColdCacheSetup(info, length, poolBytes, data_real.data(), data_imag.data(), slots)) {
+                printf("%-6s setup failed\n", label.c_str());
+                FFTRecord record = FFTColdCacheRecord(info, length, false, "cold");
+                record.status = FFTBenchStatusSetupFailed;
+                records.push_back(record);
+                failures++;
+                continue;
+            }
+            bool inPlace = FFTLayoutIsInPlace(slots[0].layout);
+            double flops = 2 * FFTRooflineFlops(length, info->transform); // fft + ifft
+
+            const FFTColdCacheSlot &hot = slots[0];
+            FFTTiming hotTiming = FFTTimerMeasure(timer, batch, [&](long n) {
+                for (long r = 0; r < n; r++) FFTColdCacheRoundtrip(hot, length);
+            });
+
+            size_t next = 0;
+            FFTTiming coldTiming = FFTTimerMeasure(timer, batch, [&](long n) {
+                for (long r = 0; r < n; r++) {
+                    FFTColdCacheRoundtrip(slots[next], length);
+                    if (++next == slots.size()) next = 0;
+                }
+            });
+
+            FFTBenchPrintTiming(label.c_str(), "hot", hotTiming, flops);
+            FFTBenchPrintTiming(label.c_str(), "cold", coldTiming, flops);
+            records.push_back(FFTColdCacheRecord(info, length, inPlace, "hot"));
+            records.back().timing = hotTiming;
+            records.push_back(FFTColdCacheRecord(info, length, inPlace, "cold"));
+            records.back().timing = coldTiming;
+
+            FFTTiming flushTiming = FFTTiming();
+            if (options.flushCache) {
+                flushTiming = FFTColdCacheMeasureFlushed(options, slots, length);
+                FFTBenchPrintTiming(label.c_str(), "flush", flushTiming, flops);
+                records.push_back(FFTColdCacheRecord(info, length, inPlace, "flushed"));
+                records.back().timing = flushTiming;
+            }
+
+            printf("%-6s cold/hot %.2fx", label.c_str(), coldTiming.ns.median / hotTiming.ns.median);
+            if (options.flushCache) printf("  flushed/hot %.2fx", flushTiming.ns.median / hotTiming.ns.median);
+            printf("  (%zu instances, ~%.1f KB each)\n", slots.size(),
+                   FFTColdCacheSlotBytes(slots[0].layout, length) / 1024.0);
+            FFTColdCacheRelease(slots);
+        }
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
@@ -0,0 +1,38 @@
+//
+//  FFTColdCache.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTColdCache__
+#define __FFTBench__FFTColdCache__
+
+#include "FFTBench.h"
+
+/*
+ Hot versus cold caches. The sweep reuses one setup and one input buffer, so
+ plan, twiddles and data stay in L1. Here every backend runs the same loop
+
+    for() {
+      input();
+      fft();
+      ifft();
+    }
+
+ three ways:
+
+    hot:      on one instance, as in the sweep
+    cold:     rotating through a pool of independent instances (plan, buffers
+              and input each), options.coldPoolBytes in total, larger than LLC
+    flushed:  one call at a time, each after a sweep through a buffer larger
+              than the data caches (options.flushCache)
+ */
+
+/// Run the hot/cold comparison over the lengths of options, return the number of failures.
+int FFTColdCacheRun(const FFTBenchOptions &options);
+
+/// Evict the data caches by touching every line of a buffer 1.5x their size.
+void FFTColdCacheFlush(void);
+
+#endif /* defined(__FFTBench__FFTColdCache__) */
@@ -0,0 +1,133 @@
+//
+//  FFTCounters.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTCounters.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define FFTCOUNTERS_HAS_PERF 1
+#endif
+
+
+const char *FFTCounterName(FFTCounter counter) {
+    switch (counter) {
+        case FFTCounterCycles: return "cycles";
+        case FFTCounterInstructions: return "instructions";
+        case FFTCounterL1DMisses: return "l1d_misses";
+        case FFTCounterLLCMisses: return "llc_misses";
+        case FFTCounterBranchMisses: return "branch_misses";
+        case FFTCounterDTLBMisses: return "dtlb_misses";
+        default: return "";
+    }
+}
+
+
+FFTCounters::FFTCounters() : _error(NULL) {
+    for (int i = 0; i < FFTCounterCount; i++) _fds[i] = -1;
+}
+
+FFTCounters::~FFTCounters() {
+#if FFTCOUNTERS_HAS_PERF
+    for (int i = 0; i < FFTCounterCount; i++) {
+        if (_fds[i] >= 0) close(_fds[i]);
+    }
+#endif
+}
+
+bool FFTCounters::isOpen() const {
+    for (int i = 0; i < FFTCounterCount; i++) {
+        if (_fds[i] >= 0) return true;
+    }
+    return false;
+}
+
+
+#if FFTCOUNTERS_HAS_PERF
+
+static int FFTCountersOpenEvent(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1; // allowed with perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0); // this thread, any cpu
+}
+
+static uint64_t FFTCountersCacheMiss(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+bool FFTCounters::open() {
+    if (isOpen()) return true;
+    _fds[FFTCounterCycles] = FFTCountersOpenEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    int firstErrno = errno;
+    _fds[FFTCounterInstructions] = FFTCountersOpenEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    _fds[FFTCounterL1DMisses] = FFTCountersOpenEvent(PERF_TYPE_HW_CACHE, FFTCountersCacheMiss(PERF_COUNT_HW_CACHE_L1D));
+    _fds[FFTCounterLLCMisses] = FFTCountersOpenEvent(PERF_TYPE_HW_CACHE, FFTCountersCacheMiss(PERF_COUNT_HW_CACHE_LL));
+    _fds[FFTCounterBranchMisses] = FFTCountersOpenEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    _fds[FFTCounterDTLBMisses] = FFTCountersOpenEvent(PERF_TYPE_HW_CACHE, FFTCountersCacheMiss(PERF_COUNT_HW_CACHE_DTLB));
+
+    if (isOpen()) return true;
+    _error = strerror(firstErrno);
+    return false;
+}
+
+void FFTCounters::start() {
+    for (int i = 0; i < FFTCounterCount; i++) {
+        if (_fds[i] < 0) continue;
+        ioctl(_fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void FFTCounters::stop() {
+    for (int i = FFTCounterCount - 1; i >= 0; i--) {
+        if (_fds[i] >= 0) ioctl(_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+}
+
+FFTCounterSample FFTCounters::read(long iterations) const {
+    FFTCounterSample sample;
+    for (int i = 0; i < FFTCounterCount; i++) {
+        sample.values[i] = -1;
+        if (_fds[i] < 0) continue;
+        uint64_t data[3]; // value, time enabled, time running
+        if (::read(_fds[i], data, sizeof(data)) != (ssize_t)sizeof(data) || data[2] == 0) continue;
+        double scale = (double)data[1] / data[2];
+        sample.values[i] = data[0] * scale / (iterations > 0 ? iterations : 1);
+    }
+    return sample;
+}
+
+#else
+
+bool FFTCounters::open() {
+    _error = "perf_event_open is Linux only";
+    return false;
+}
+
+void FFTCounters::start() {}
+void FFTCounters::stop() {}
+
+FFTCounterSample FFTCounters::read(long iterations) const {
+    FFTCounterSample sample;
+    for (int i = 0; i < FFTCounterCount; i++) sample.values[i] = -1;
+    return sample;
+}
+
+#endif
@@ -0,0 +1,78 @@
+//
+//  FFTCounters.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTCounters__
+#define __FFTBench__FFTCounters__
+
+/*
+ Hardware performance counters of the calling thread (Linux perf_event_open,
+ user space only). Every event is opened on its own so the kernel can
+ multiplex them; counts are scaled by time_enabled / time_running.
+
+    counters.open();
+    FFTCounterSample s = FFTCountersMeasure(counters, batch, block);   // per iteration
+
+ Elsewhere open() fails and the harness runs without counters.
+ */
+
+typedef enum {
+    FFTCounterCycles,
+    FFTCounterInstructions,
+    FFTCounterL1DMisses,       ///< L1 data cache read misses
+    FFTCounterLLCMisses,       ///< last level cache read misses
+    FFTCounterBranchMisses,
+    FFTCounterDTLBMisses,      ///< data TLB read misses
+    FFTCounterCount,
+} FFTCounter;
+
+/// Short name, as used in the text, json and csv output.
+const char *FFTCounterName(FFTCounter counter);
+
+
+/// Counts per iteration, negative for a counter this cpu or kernel does not provide.
+struct FFTCounterSample {
+    double values[FFTCounterCount];
+};
+
+
+class FFTCounters {
+public:
+    FFTCounters();
+    ~FFTCounters();
+
+    /// Open every event that exists here, false (with `error` set) if none does.
+    bool open();
+    bool isOpen() const;
+    const char *error() const { return _error; }
+
+    void start();
+    void stop();
+
+    /// Counts since start(), divided by `iterations`.
+    FFTCounterSample read(long iterations) const;
+
+private:
+    FFTCounters(const FFTCounters &);
+    FFTCounters &operator=(const FFTCounters &);
+
+    int _fds[FFTCounterCount];
+    const char *_error;
+};
+
+
+/// Counts per iteration of `block(n)`, which must run its operation n times.
+template <typename Block>
+FFTCounterSample FFTCountersMeasure(FFTCounters &counters, long batch, Block block) {
+    if (batch < 1) batch = 1;
+    block(batch); // warm caches and TLB as the timed trials have
+    counters.start();
+    block(batch);
+    counters.stop();
+    return counters.read(batch);
+}
+
+#endif /* defined(__FFTBench__FFTCounters__) */
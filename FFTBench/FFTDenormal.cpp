@@ -0,0 +1,180 @@
+//
+//  FFTDenormal.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTDenormal.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+// Seconds per cell when timing by points: a subnormal cell can be 100x slower than the noise cell.
+#define FFTDenormalBudget 0.2
+
+
+/// One timed (signal, FTZ/DAZ) condition of a backend.
+struct FFTDenormalCell {
+    bool valid;
+    FFTTiming timing;
+    FFTError error;
+};
+
+
+/// Check the forward transform of a set-up backend on one input, then time it under the
+/// current FTZ/DAZ state; in-place backends get their input copied back before every call.
+static FFTDenormalCell FFTDenormalMeasure(FFTBackend *backend, int length,
+                                          const double *data_real, const double *data_imag,
+                                          const double *idft_real, const double *idft_imag,
+                                          const FFTBenchOptions &options) {
+    FFTDenormalCell cell = FFTDenormalCell();
+    FFTLayout layout = backend->layout();
+    std::vector<double> real(length), imag(length);
+    FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+    backend->forward();
+    FFTSpectrumStore(layout, real.data(), imag.data(), length, 1.0 / layout.forwardScale);
+    cell.error = FFTErrorCompute(real.data(), imag.data(), idft_real, idft_imag, FFTLayoutSpectrumBins(layout, length));
+    cell.valid = cell.error.rms <= FFTBenchTolerance(layout.precision);
+
+    FFTBufferImage image;
+    FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+    image.capture(layout.input, layout.precision, length, layout.lanes);
+    bool restore = FFTLayoutIsInPlace(layout);
+    long batch = options.points / length / options.timer.trials;
+    FFTTimerOptions timer = options.timer;
+    if (timer.budget <= 0) timer.budget = FFTDenormalBudget;
+    cell.timing = FFTTimerMeasure(timer, batch, [&](long n) {
+        for (long r = 0; r < n; r++) {
+            if (restore) image.restore();
+            backend->forward();
+        }
+    });
+    return cell;
+}
+
+
+int FFTDenormalRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    FFTBenchPrintEnvironment();
+    bool canFlush = FFTSignalCanFlushDenormals();
+    if (!canFlush) fprintf(stderr, "FTZ/DAZ not available on this cpu, timing with subnormals only\n");
+    printf("denormals: forward ns per input signal, FTZ/DAZ off and on\n");
+    int modes = canFlush ? 2 : 1;
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        int length = lengths[l];
+        printf("%d-------\n", length);
+
+        std::vector<std::vector<double> > data_real(FFTSignalCount), data_imag(FFTSignalCount);
+        std::vector<std::vector<double> > idft_real(FFTSignalCount), idft_imag(FFTSignalCount);
+        for (int s = 0; s < FFTSignalCount; s++) {
+            data_real[s].resize(length);
+            data_imag[s].resize(length);
+            idft_real[s].resize(length);
+            idft_imag[s].resize(length);
+            FFTSignalGenerate((FFTSignal)s, options.transform, options.precision, data_real[s].data(),
+                              data_imag[s].data(), length);
+            FFTReferenceDFT(data_real[s].data(), data_imag[s].data(), idft_real[s].data(), idft_imag[s].data(),
+                            length, -1);
+        }
+
+        std::vector<std::string> labels;
+        std::vector<std::vector<double> > ratios;
+        for (size_t b = 0; b < backends.size(); b++) {
+            const FFTBackendInfo *info = backends[b];
+            std::string label = std::string(info->name) + ":";
+            FFTBackend *backend = info->create();
+            if (!backend->supports(length)) {
+                delete backend;
+                continue;
+            }
+            FFTRecord record = FFTRecord();
+            record.backend = info->name;
+            record.length = length;
+            record.precision = info->precision;
+            record.transform = info->transform;
+            record.direction = "fwd";
+            record.threads = 1;
+            record.premarshal = true;
+            if (!backend->setup(length)) {
+                printf("%-6s setup failed\n", label.c_str());
+                backend->teardown();
+                delete backend;
+                record.status = FFTBenchStatusSetupFailed;
+                records.push_back(record);
+                failures++;
+                continue;
+            }
+            record.inPlace = FFTLayoutIsInPlace(backend->layout());
+            record.peakBytes = -1;
+            double flops = FFTRooflineFlops(length, info->transform);
+
+            std::vector<double> row(2 * FFTSignalCount, 0);
+            double noise = 0;
+            for (int s = 0; s < FFTSignalCount; s++) {
+                for (int f = 0; f < modes; f++) {
+                    FFTSignal signal = (FFTSignal)s;
+                    bool flush = f == 1;
+                    bool previous = canFlush ? FFTSignalSetFlushDenormals(flush) : false;
+                    FFTDenormalCell cell = FFTDenormalMeasure(backend, length, data_real[s].data(), data_imag[s].data(),
+                                                              idft_real[s].data(), idft_imag[s].data(), options);
+                    if (canFlush) FFTSignalSetFlushDenormals(previous);
+
+                    std::string name = std::string(FFTSignalName(signal)) + (flush ? "+ftz" : "");
+                    FFTBenchPrintTiming(label.c_str(), name.c_str(), cell.timing, flops);
+                    if (!cell.valid) {
+                        printf("%-6s %-5s invalid, rms error %.3g%s\n", label.c_str(), name.c_str(), cell.error.rms,
+                               flush ? " (flushed)" : "");
+                        if (!flush) failures++;
+                    }
+                    record.status = cell.valid ? FFTBenchStatusOK : FFTBenchStatusInvalid;
+                    record.timing = cell.timing;
+                    record.error = cell.error;
+                    record.signal = FFTSignalName(signal);
+                    record.flushDenormals = flush;
+                    records.push_back(record);
+
+                    if (signal == FFTSignalNoise && !flush) noise = cell.timing.ns.median;
+                    row[s * 2 + f] = cell.timing.ns.median;
+                }
+            }
+            backend->teardown();
+            delete backend;
+            for (size_t c = 0; c < row.size(); c++) {
+                if (noise > 0) row[c] /= noise;
+            }
+            labels.push_back(label);
+            ratios.push_back(row);
+        }
+
+        printf("slowdown against noise without FTZ/DAZ\n");
+        int width = 8;
+        for (size_t r = 0; r < labels.size(); r++) width = std::max(width, (int)labels[r].size());
+        printf("%-*s", width, "");
+        for (int s = 0; s < FFTSignalCount; s++) {
+            printf(" %8s", FFTSignalName((FFTSignal)s));
+            if (modes > 1) printf(" %8s", "ftz");
+        }
+        printf("\n");
+        for (size_t r = 0; r < labels.size(); r++) {
+            printf("%-*s", width, labels[r].c_str());
+            for (int s = 0; s < FFTSignalCount; s++) {
+                for (int f = 0; f < modes; f++) printf(" %8.2f", ratios[r][s * 2 + f]);
+            }
+            printf("\n");
+        }
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
@@ -0,0 +1,32 @@
+//
+//  FFTDenormal.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTDenormal__
+#define __FFTBench__FFTDenormal__
+
+#include "FFTBench.h"
+
+/*
+ Denormal sensitivity: near-silence fading into subnormal numbers can make
+ scalar butterflies many times slower, since every operation on a subnormal
+ operand or result takes a microcode assist. Every backend's forward transform
+ is timed on each input of FFTSignal.h, with FTZ/DAZ off and on
+
+    ./FFTBench --denormals -b kiss -b pffft
+    ./FFTBench --denormals --double --max-log2 10
+
+ and the summary is the slowdown against noise with FTZ/DAZ off, so the decay
+ columns give the denormal penalty per library and its `ftz` column what
+ enforcing flush-to-zero buys back. Flushing changes the result of the decay
+ input; a cell that fails validation only with FTZ/DAZ on is reported but not
+ counted as a failure.
+ */
+
+/// Run the denormal benchmark over the lengths of options, return the number of failures.
+int FFTDenormalRun(const FFTBenchOptions &options);
+
+#endif /* defined(__FFTBench__FFTDenormal__) */
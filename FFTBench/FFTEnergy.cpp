@@ -0,0 +1,148 @@
+//
+//  FFTEnergy.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTEnergy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <dirent.h>
+#define FFTENERGY_HAS_POWERCAP 1
+#endif
+
+#ifndef FFTENERGY_POWERCAP
+#define FFTENERGY_POWERCAP "/sys/class/powercap"
+#endif
+
+
+const char *FFTEnergyDomainName(FFTEnergyDomain domain) {
+    switch (domain) {
+        case FFTEnergyPackage: return "package";
+        case FFTEnergyDRAM: return "dram";
+        default: return "";
+    }
+}
+
+
+FFTEnergy::FFTEnergy() : _startNs(0), _stopNs(0), _error(NULL) {}
+
+bool FFTEnergy::isOpen() const {
+    for (int d = 0; d < FFTEnergyDomainCount; d++) {
+        if (!_zones[d].empty()) return true;
+    }
+    return false;
+}
+
+
+#if FFTENERGY_HAS_POWERCAP
+
+/// First line of a sysfs file, false if it cannot be read.
+static bool FFTEnergyReadLine(const std::string &path, char *line, int size) {
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file) return false;
+    bool ok = fgets(line, size, file) != NULL;
+    fclose(file);
+    if (ok) line[strcspn(line, "\n")] = 0;
+    return ok;
+}
+
+/// Microjoules, negative if unreadable.
+static double FFTEnergyReadCounter(const std::string &path) {
+    char line[64];
+    if (!FFTEnergyReadLine(path, line, sizeof(line))) return -1;
+    return strtod(line, NULL);
+}
+
+bool FFTEnergy::open() {
+    if (isOpen()) return true;
+    DIR *dir = opendir(FFTENERGY_POWERCAP);
+    if (!dir) {
+        _error = "no " FFTENERGY_POWERCAP " (intel_rapl driver not loaded, or a VM)";
+        return false;
+    }
+    bool found = false;
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        // intel-rapl:<socket> is a package (or on some servers dram), intel-rapl:<socket>:<n> its
+        // core/uncore/dram subzones; intel-rapl-mmio:* repeats the packages and is skipped
+        if (strncmp(entry->d_name, "intel-rapl:", 11)) continue;
+        std::string zone = std::string(FFTENERGY_POWERCAP "/") + entry->d_name + "/";
+        char name[64];
+        if (!FFTEnergyReadLine(zone + "name", name, sizeof(name))) continue;
+        int domain;
+        if (!strncmp(name, "package", 7)) domain = FFTEnergyPackage;
+        else if (!strcmp(name, "dram")) domain = FFTEnergyDRAM;
+        else continue;
+        found = true;
+
+        Zone z;
+        z.path = zone + "energy_uj";
+        z.range = FFTEnergyReadCounter(zone + "max_energy_range_uj");
+        z.start = z.stop = 0;
+        if (FFTEnergyReadCounter(z.path) < 0) continue;
+        _zones[domain].push_back(z);
+    }
+    closedir(dir);
+
+    if (isOpen()) return true;
+    _error = found ? "energy_uj is not readable (root only since Linux 5.10)" : "no RAPL package zone";
+    return false;
+}
+
+void FFTEnergy::start() {
+    for (int d = 0; d < FFTEnergyDomainCount; d++) {
+        for (size_t i = 0; i < _zones[d].size(); i++) _zones[d][i].start = FFTEnergyReadCounter(_zones[d][i].path);
+    }
+    _startNs = FFTTimerNanoseconds();
+}
+
+void FFTEnergy::stop() {
+    _stopNs = FFTTimerNanoseconds();
+    for (int d = 0; d < FFTEnergyDomainCount; d++) {
+        for (size_t i = 0; i < _zones[d].size(); i++) _zones[d][i].stop = FFTEnergyReadCounter(_zones[d][i].path);
+    }
+}
+
+FFTEnergySample FFTEnergy::read(long iterations) const {
+    FFTEnergySample sample;
+    if (iterations < 1) iterations = 1;
+    for (int d = 0; d < FFTEnergyDomainCount; d++) {
+        sample.joules[d] = -1;
+        if (_zones[d].empty()) continue;
+        double uj = 0;
+        for (size_t i = 0; i < _zones[d].size(); i++) {
+            const Zone &z = _zones[d][i];
+            double delta = z.stop - z.start;
+            if (delta < 0 && z.range > 0) delta += z.range; // wrapped once; a run is far shorter than a wrap
+            uj += delta;
+        }
+        sample.joules[d] = uj * 1e-6 / iterations;
+    }
+    sample.seconds = (_stopNs - _startNs) * 1e-9 / iterations;
+    return sample;
+}
+
+#else
+
+bool FFTEnergy::open() {
+    _error = "RAPL energy counters are read through Linux powercap";
+    return false;
+}
+
+void FFTEnergy::start() {}
+void FFTEnergy::stop() {}
+
+FFTEnergySample FFTEnergy::read(long iterations) const {
+    FFTEnergySample sample;
+    for (int d = 0; d < FFTEnergyDomainCount; d++) sample.joules[d] = -1;
+    sample.seconds = 0;
+    return sample;
+}
+
+#endif
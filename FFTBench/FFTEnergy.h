@@ -0,0 +1,98 @@
+//
+//  FFTEnergy.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTEnergy__
+#define __FFTBench__FFTEnergy__
+
+#include "FFTTimer.h"
+
+#include <string>
+#include <vector>
+
+/*
+ RAPL energy counters (Linux powercap, /sys/class/powercap/intel-rapl:*, also
+ provided for AMD Zen by the same driver). Package zones of all sockets are
+ summed, and so are their dram subzones.
+
+    energy.open();
+    FFTEnergySample s = FFTEnergyMeasure(energy, batch, block);   // per iteration
+
+ The counters cover the whole socket (other cores, uncore, idle power), not
+ this thread, and advance about every millisecond, so a measurement repeats
+ the block for at least FFTEnergySeconds and should run on an idle machine.
+ Since Linux 5.10 energy_uj is readable by root only; elsewhere, or without
+ the driver (VMs), open() fails and the harness runs without energy.
+ */
+
+/// Shortest measured run, seconds: some 250 counter updates.
+#define FFTEnergySeconds 0.25
+
+typedef enum {
+    FFTEnergyPackage,          ///< cores, caches and uncore of every socket
+    FFTEnergyDRAM,             ///< memory controllers and DIMMs, where the platform reports them
+    FFTEnergyDomainCount,
+} FFTEnergyDomain;
+
+/// Short name, as used in the text, json and csv output.
+const char *FFTEnergyDomainName(FFTEnergyDomain domain);
+
+
+/// Joules per iteration, negative for a domain this machine does not report.
+struct FFTEnergySample {
+    double joules[FFTEnergyDomainCount];
+    double seconds;            ///< wall time per iteration, joules / seconds is the mean power
+};
+
+
+class FFTEnergy {
+public:
+    FFTEnergy();
+
+    /// Find the readable zones, false (with `error` set) if there is none.
+    bool open();
+    bool isOpen() const;
+    const char *error() const { return _error; }
+
+    void start();
+    void stop();
+
+    /// Energy since start(), divided by `iterations`.
+    FFTEnergySample read(long iterations) const;
+
+private:
+    struct Zone {
+        std::string path;      ///< energy_uj
+        double range;          ///< max_energy_range_uj, where the counter wraps
+        double start;
+        double stop;
+    };
+
+    std::vector<Zone> _zones[FFTEnergyDomainCount];
+    uint64_t _startNs;
+    uint64_t _stopNs;
+    const char *_error;
+};
+
+
+/// Energy per iteration of `block(n)`, which must run its operation n times;
+/// repeats block(batch) until FFTEnergySeconds have passed.
+template <typename Block>
+FFTEnergySample FFTEnergyMeasure(FFTEnergy &energy, long batch, Block block) {
+    if (batch < 1) batch = 1;
+    block(batch); // warm caches as the timed trials have
+    long iterations = 0;
+    uint64_t end = FFTTimerNanoseconds() + (uint64_t)(FFTEnergySeconds * 1e9);
+    energy.start();
+    do {
+        block(batch);
+        iterations += batch;
+    } while (FFTTimerNanoseconds() < end);
+    energy.stop();
+    return energy.read(iterations);
+}
+
+#endif /* defined(__FFTBench__FFTEnergy__) */
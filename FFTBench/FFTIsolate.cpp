@@ -0,0 +1,346 @@
+//
+//  FFTIsolate.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTIsolate.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// rounds of --isolate 0
+#define FFTIsolateDefaultRounds 5
+
+// ci95 width, as a fraction of the median, a cell counts as reproducible within
+#define FFTIsolateTarget 0.01
+
+
+/// Options of the parent that the children get replaced (cells, outputs) or must not see.
+static const char *FFTIsolateParentOptions[] = {
+    "--isolate", "--cpu", "-b", "--backend", "--lengths", "--min-log2", "--max-log2", "--sizes",
+    "--json", "--csv", "--baseline", "--save-baseline", "--threshold",
+};
+
+/// Phases of a sweep record, in print order; the record directions point here.
+static const char *FFTIsolateDirections[] = {"load", "fwd", "inv", "store"};
+
+
+/// First line of a small sysfs file, "" if it cannot be read.
+static std::string FFTIsolateReadLine(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) return "";
+    char line[256] = "";
+    if (!fgets(line, sizeof(line), file)) line[0] = '\0';
+    fclose(file);
+    std::string s = line;
+    while (!s.empty() && (s[s.size() - 1] == '\n' || s[s.size() - 1] == ' ')) s.erase(s.size() - 1);
+    return s;
+}
+
+/// Cpus of a sysfs list like "2-3,5".
+static std::vector<int> FFTIsolateParseCpus(const std::string &list) {
+    std::vector<int> cpus;
+    for (const char *p = list.c_str(); *p; ) {
+        int first = atoi(p), last = first;
+        const char *dash = strchr(p, '-'), *comma = strchr(p, ',');
+        if (dash && (!comma || dash < comma)) last = atoi(dash + 1);
+        for (int c = first; c <= last; c++) cpus.push_back(c);
+        if (!comma) break;
+        p = comma + 1;
+    }
+    return cpus;
+}
+
+/// "on", "off" or "unknown": intel_pstate's no_turbo, else the cpufreq boost switch (acpi-cpufreq, amd).
+static const char *FFTIsolateTurbo(void) {
+    std::string noTurbo = FFTIsolateReadLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+    if (!noTurbo.empty()) return noTurbo == "1" ? "off" : "on";
+    std::string boost = FFTIsolateReadLine("/sys/devices/system/cpu/cpufreq/boost");
+    if (!boost.empty()) return boost == "0" ? "off" : "on";
+    return "unknown";
+}
+
+/// Core of the children, and a one-line description of its clock and isolation; warns on what adds noise.
+static int FFTIsolateChooseCpu(const FFTBenchOptions &options) {
+    std::vector<int> isolated = FFTIsolateParseCpus(FFTIsolateReadLine("/sys/devices/system/cpu/isolated"));
+    int cpu = options.isolateCpu;
+    if (cpu < 0) cpu = !isolated.empty() ? isolated.back() : (int)std::thread::hardware_concurrency() - 1;
+    if (cpu < 0) cpu = 0;
+    bool isIsolated = std::find(isolated.begin(), isolated.end(), cpu) != isolated.end();
+
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor", cpu);
+    std::string governor = FFTIsolateReadLine(path);
+    const char *turbo = FFTIsolateTurbo();
+    printf("isolate: cpu %d (%s), governor %s, turbo %s\n", cpu, isIsolated ? "isolated" : "shared",
+           governor.empty() ? "unknown" : governor.c_str(), turbo);
+
+    if (!isIsolated) {
+        fprintf(stderr, "warning: cpu %d is not in isolcpus, other tasks may be scheduled on it\n", cpu);
+    }
+    if (!governor.empty() && governor != "performance") {
+        fprintf(stderr, "warning: governor %s lets the clock of cpu %d follow the load, set it to performance\n",
+                governor.c_str(), cpu);
+    }
+    if (!strcmp(turbo, "on")) {
+        fprintf(stderr, "warning: turbo is on, the clock depends on temperature and the other cores\n");
+    }
+    return cpu;
+}
+
+
+/// Path of the running executable, for the children.
+static std::string FFTIsolateExecutable(const char *argv0) {
+#if defined(__linux__)
+    char path[4096];
+    ssize_t n = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (n > 0) {
+        path[n] = '\0';
+        return path;
+    }
+#endif
+    return argv0;
+}
+
+/// The parent's command line without its cells and outputs.
+static std::vector<std::string> FFTIsolatePassedOptions(int argc, const char *argv[]) {
+    std::vector<std::string> passed;
+    int count = sizeof(FFTIsolateParentOptions) / sizeof(FFTIsolateParentOptions[0]);
+    for (int i = 1; i < argc; i++) {
+        bool parent = false;
+        for (int o = 0; o < count && !parent; o++) parent = !strcmp(argv[i], FFTIsolateParentOptions[o]);
+        if (parent) {
+            i++; // all of them take a value
+            continue;
+        }
+        passed.push_back(argv[i]);
+    }
+    return passed;
+}
+
+/// Run `args` pinned to `cpu` with stdout discarded, true if it exited with status 0.
+static bool FFTIsolateSpawn(const std::string &executable, const std::vector<std::string> &args, int cpu) {
+#if defined(_WIN32)
+    (void)executable;
+    (void)args;
+    (void)cpu;
+    return false;
+#else
+    std::vector<char *> list;
+    list.push_back((char *)executable.c_str());
+    for (size_t i = 0; i < args.size(); i++) list.push_back((char *)args[i].c_str());
+    list.push_back(NULL);
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0) dup2(null, STDOUT_FILENO);
+        execv(executable.c_str(), list.data());
+        _exit(127);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+}
+
+
+/// One (backend, length, direction) over the rounds.
+struct FFTIsolateCell {
+    FFTRecord record;              ///< of the first round, timing replaced by the aggregate
+    std::vector<double> medians;   ///< ns, one per round
+    std::vector<double> cycles;
+};
+
+static FFTBenchStatus FFTIsolateStatus(const std::string &name) {
+    if (name == "ok") return FFTBenchStatusOK;
+    if (name == "setup-failed") return FFTBenchStatusSetupFailed;
+    if (name == "memory-limit") return FFTBenchStatusMemoryLimit;
+    if (name == "unsupported") return FFTBenchStatusUnsupported;
+    return FFTBenchStatusInvalid;
+}
+
+/// Add the rows of a child's csv to the cells, false if it has none.
+static bool FFTIsolateCollect(const char *path, const FFTBackendInfo *info,
+                              std::map<std::string, FFTIsolateCell> &cells) {
+    std::vector<std::string> header;
+    std::vector<std::map<std::string, std::string> > rows;
+    if (!FFTReportReadCSV(path, header, rows) || rows.empty()) return false;
+    int count = sizeof(FFTIsolateDirections) / sizeof(FFTIsolateDirections[0]);
+    for (size_t r = 0; r < rows.size(); r++) {
+        std::map<std::string, std::string> &f = rows[r];
+        const char *direction = NULL;
+        for (int d = 0; d < count; d++) {
+            if (f["direction"] == FFTIsolateDirections[d]) direction = FFTIsolateDirections[d];
+        }
+        if (!direction || f["backend"] != info->name) continue;
+
+        std::string key = f["backend"] + "|" + f["length"] + "|" + direction;
+        FFTIsolateCell &cell = cells[key];
+        FFTRecord &record = cell.record;
+        FFTBenchStatus status = FFTIsolateStatus(f["status"]);
+        if (record.backend.empty()) { // first round of the cell
+            record = FFTRecord();
+            record.backend = info->name;
+            record.length = atoi(f["length"].c_str());
+            record.precision = info->precision;
+            record.transform = info->transform;
+            record.inPlace = f["layout"] == "in-place";
+            record.direction = direction;
+            record.threads = 1;
+            record.premarshal = f["premarshal"] == "1";
+            record.status = status;
+            record.peakBytes = -1;
+        } else if (status != FFTBenchStatusOK) {
+            record.status = status;
+        }
+        record.error.rms = std::max(record.error.rms, atof(f["error_rms"].c_str()));
+        record.error.max = std::max(record.error.max, atof(f["error_max"].c_str()));
+        if (status != FFTBenchStatusOK || f["median_ns"].empty()) continue;
+        cell.medians.push_back(atof(f["median_ns"].c_str()));
+        if (!f["cycles"].empty()) cell.cycles.push_back(atof(f["cycles"].c_str()));
+    }
+    return true;
+}
+
+
+int FFTIsolateRun(const FFTBenchOptions &options, int argc, const char *argv[]) {
+#if defined(_WIN32)
+    fprintf(stderr, "--isolate needs fork/exec, not available on this platform\n");
+    return 1;
+#else
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    FFTBenchPrintEnvironment();
+    int cpu = FFTIsolateChooseCpu(options);
+    int rounds = options.isolateRounds > 0 ? options.isolateRounds : FFTIsolateDefaultRounds;
+
+    char directory[] = "/tmp/fftbench-isolate-XXXXXX";
+    if (!mkdtemp(directory)) {
+        fprintf(stderr, "cannot create a directory for the children's results\n");
+        return 1;
+    }
+    std::string csv = std::string(directory) + "/cell.csv";
+    std::string executable = FFTIsolateExecutable(argv[0]);
+    std::vector<std::string> passed = FFTIsolatePassedOptions(argc, argv);
+
+    std::vector<int> lengths = FFTBenchLengths(options);
+    std::vector<std::pair<const FFTBackendInfo *, int> > order;
+    for (size_t l = 0; l < lengths.size(); l++) {
+        for (size_t b = 0; b < backends.size(); b++) {
+            FFTBackend *backend = backends[b]->create();
+            if (backend->supports(lengths[l])) order.push_back(std::make_pair(backends[b], lengths[l]));
+            delete backend;
+        }
+    }
+    unsigned seed = std::random_device()();
+    std::mt19937 random(seed);
+    printf("%d rounds of %d cells, one process each, order seed %u\n", rounds, (int)order.size(), seed);
+
+    int failures = 0;
+    std::map<std::string, FFTIsolateCell> cells;
+    for (int round = 0; round < rounds; round++) {
+        std::shuffle(order.begin(), order.end(), random);
+        printf("round %d/%d\n", round + 1, rounds);
+        for (size_t c = 0; c < order.size(); c++) {
+            const FFTBackendInfo *info = order[c].first;
+            std::vector<std::string> args = passed;
+            args.push_back("-b");
+            args.push_back(info->name);
+            args.push_back("--lengths");
+            args.push_back(std::to_string(order[c].second));
+            args.push_back("--csv");
+            args.push_back(csv);
+            remove(csv.c_str());
+            bool ok = FFTIsolateSpawn(executable, args, cpu);
+            if (!FFTIsolateCollect(csv.c_str(), info, cells) || !ok) {
+                fprintf(stderr, "%s %d: child failed\n", info->name, order[c].second);
+                failures++;
+            }
+        }
+    }
+    remove(csv.c_str());
+    rmdir(directory);
+
+    // print and record in sweep order, the medians over the rounds
+    std::vector<FFTRecord> records;
+    int stable = 0, timed = 0;
+    double worst = 0;
+    std::string worstCell;
+    int count = sizeof(FFTIsolateDirections) / sizeof(FFTIsolateDirections[0]);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        printf("%d-------\n", lengths[l]);
+        for (size_t b = 0; b < backends.size(); b++) {
+            std::string label = std::string(backends[b]->name) + ":";
+            for (int d = 0; d < count; d++) {
+                std::string key = std::string(backends[b]->name) + "|" + std::to_string(lengths[l]) + "|" +
+                                  FFTIsolateDirections[d];
+                std::map<std::string, FFTIsolateCell>::iterator it = cells.find(key);
+                if (it == cells.end()) continue;
+                FFTIsolateCell &cell = it->second;
+                FFTRecord &record = cell.record;
+                if (cell.medians.empty()) {
+                    printf("%-6s %-5s no timed round\n", label.c_str(), record.direction);
+                    records.push_back(record);
+                    continue;
+                }
+                record.timing.batch = 1;
+                record.timing.ns = FFTStatsCompute(cell.medians);
+                record.timing.cycles = FFTStatsCompute(cell.cycles);
+                bool phase = d == 1 || d == 2;
+                FFTBenchPrintTiming(label.c_str(), record.direction, record.timing,
+                                    phase ? FFTRooflineFlops(lengths[l], record.transform) : 0);
+                records.push_back(record);
+                if (!phase) continue;
+
+                double width = (record.timing.ns.ciHigh - record.timing.ns.ciLow) / record.timing.ns.median;
+                timed++;
+                if (width <= FFTIsolateTarget) stable++;
+                if (width > worst) {
+                    worst = width;
+                    worstCell = std::string(backends[b]->name) + " " + std::to_string(lengths[l]) + " " +
+                                record.direction;
+                }
+            }
+        }
+    }
+    printf("\nreproducibility: fwd/inv ci95 of the median within %.0f%% in %d of %d cells", FFTIsolateTarget * 100,
+           stable, timed);
+    if (!worstCell.empty()) printf(", widest %.1f%% (%s)", worst * 100, worstCell.c_str());
+    printf("\n");
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+#endif
+}
@@ -0,0 +1,43 @@
+//
+//  FFTIsolate.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTIsolate__
+#define __FFTBench__FFTIsolate__
+
+#include "FFTBench.h"
+
+/*
+ Isolated sweep: in one process the contenders run one after another, and
+ heap fragmentation, cache and page state and the turbo history of the one
+ before leak into the next. Here every (backend, length) cell is a fresh
+ child process, the same binary with the same options running just that cell
+
+    ./FFTBench --isolate 5                     # 5 rounds, each cell once per round
+    ./FFTBench --isolate 9 --cpu 3 -b pffft -b nsfft --json results.json
+
+ pinned to one core: --cpu, else the last of /sys/devices/system/cpu/isolated
+ (isolcpus=), else the last online cpu. Each round runs all cells in a new
+ random order, so slow drift (thermals, other load) spreads over every
+ contender instead of favouring the ones run first. The result of a cell is
+ the median over the rounds of each child's median, with min/p90 and ci95 of
+ those; the summary counts the cells whose fwd/inv ci95 is within 1% of the
+ median.
+
+ Before the first child the cpufreq governor and turbo state of the core are
+ read (Linux sysfs) and a warning printed when they let the clock move:
+
+    echo performance | sudo tee /sys/devices/system/cpu/cpu3/cpufreq/scaling_governor
+    echo 1 | sudo tee /sys/devices/system/cpu/intel_pstate/no_turbo     # or cpufreq/boost = 0
+
+ Children run on POSIX systems only; core pinning is Linux only.
+ */
+
+/// Run every cell of the sweep in its own process, `argv` being the command line to pass on;
+/// return the number of failed cells.
+int FFTIsolateRun(const FFTBenchOptions &options, int argc, const char *argv[]);
+
+#endif /* defined(__FFTBench__FFTIsolate__) */
@@ -0,0 +1,247 @@
+//
+//  FFTKernels.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTKernels.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTTimer.h"
+#include "FFTSizes.h"
+#include "Kernels/FFTKernelsShim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "SIMDBase.h"
+#include "ckfft.h"
+#include "context.h"
+#include "fft_default.h"
+#include "NE10_fft.h"
+
+// the portable c2c of NE10_fft_float32.c, not in NE10_fft.h
+extern "C" void ne10_fft_c2c_1d_float32_c(ne10_fft_cpx_float32_t *fout, ne10_fft_cpx_float32_t *fin,
+                                          ne10_fft_cfg_float32_t cfg, ne10_int32_t inverse_fft);
+
+
+/// ckfft: the count == 4 or count == 8 calls fft_default's radix-4 recursion ends in, with the input
+/// stride and twiddle table stride the recursion reaches them with.
+struct FFTKernelsCkFFTState {
+    CkFftContext *context;
+    CkFftComplex *in;
+    CkFftComplex *out;
+    int count;
+    int expTableStride;
+};
+
+static void FFTKernelsCkFFTRun(const FFTKernelPass *pass, long repeats) {
+    const FFTKernelsCkFFTState *s = (const FFTKernelsCkFFTState *)pass->state;
+    int stride = (int)pass->stride;
+    for (long r = 0; r < repeats; r++) {
+        for (int j = 0; j < stride; j++) {
+            ckfft::fft_default(s->context, s->in + j, s->out + j * s->count, s->count, false, stride,
+                               s->context->fwdExpTable, s->expTableStride);
+        }
+    }
+}
+
+static void FFTKernelsCkFFTRelease(FFTKernelPass *pass) {
+    FFTKernelsCkFFTState *s = (FFTKernelsCkFFTState *)pass->state;
+    CkFftShutdown(s->context);
+    free(s->in);
+    free(s->out);
+    delete s;
+    pass->state = NULL;
+}
+
+static int FFTKernelsCkFFTPrepare(int count, int length, FFTKernelStage stage, FFTKernelPass *pass) {
+    if (stage != FFTKernelStageFirst || length < 4 * count || !FFTSizeIsPow2(length)) return 0;
+    int leaf = length;
+    while (leaf > 8) leaf /= 4;
+    if (leaf != count) return 0; // 4^k ends in count 4, 2 x 4^k in count 8
+
+    FFTKernelsCkFFTState *s = new FFTKernelsCkFFTState();
+    s->context = CkFftInit(length, kCkFftDirection_Forward, NULL, NULL);
+    s->in = (CkFftComplex *)calloc(length, sizeof(CkFftComplex));
+    s->out = (CkFftComplex *)calloc(length, sizeof(CkFftComplex));
+    s->count = count;
+    s->expTableStride = s->context->maxCount / length;
+
+    pass->state = s;
+    pass->stage = "leaf";
+    pass->calls = length / count;
+    pass->stride = length / count;
+    pass->butterflies = length / count;
+    pass->run = FFTKernelsCkFFTRun;
+    pass->release = FFTKernelsCkFFTRelease;
+    return 1;
+}
+
+
+/// ne10: the mixed radix butterfly is the whole c2c transform, ne10_fft_c2c_1d_float32_c only picks
+/// it or the inverse one.
+struct FFTKernelsNe10State {
+    ne10_fft_cfg_float32_t cfg;
+    ne10_fft_cpx_float32_t *in;
+    ne10_fft_cpx_float32_t *out;
+};
+
+static void FFTKernelsNe10Run(const FFTKernelPass *pass, long repeats) {
+    const FFTKernelsNe10State *s = (const FFTKernelsNe10State *)pass->state;
+    for (long r = 0; r < repeats; r++) ne10_fft_c2c_1d_float32_c(s->out, s->in, s->cfg, 0);
+}
+
+static void FFTKernelsNe10Release(FFTKernelPass *pass) {
+    FFTKernelsNe10State *s = (FFTKernelsNe10State *)pass->state;
+    free(s->cfg);
+    free(s->in);
+    free(s->out);
+    delete s;
+    pass->state = NULL;
+}
+
+static int FFTKernelsNe10Prepare(int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass) {
+    (void)kernel;
+    if (stage != FFTKernelStageFirst || length < 2 || !FFTSizeIsPow2(length)) return 0;
+    FFTKernelsNe10State *s = new FFTKernelsNe10State();
+    s->cfg = ne10_fft_alloc_c2c_float32(length);
+    s->in = (ne10_fft_cpx_float32_t *)calloc(length, sizeof(ne10_fft_cpx_float32_t));
+    s->out = (ne10_fft_cpx_float32_t *)calloc(length, sizeof(ne10_fft_cpx_float32_t));
+
+    pass->state = s;
+    pass->stage = "all";
+    pass->calls = 1;
+    pass->stride = 1;
+    pass->butterflies = (long)FFTBenchButterflies(length);
+    pass->run = FFTKernelsNe10Run;
+    pass->release = FFTKernelsNe10Release;
+    return 1;
+}
+
+
+static int FFTKernelsNSFFTBestPrepare(int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass) {
+    return FFTKernelsNSFFTPrepare(SIMDBase_chooseBestMode(SIMDBase_TYPE_FLOAT), kernel, length, stage, pass);
+}
+
+
+struct FFTKernelInfo {
+    const char *library;   ///< backend name of the library, matched against -b
+    const char *name;
+    const char *unit;      ///< what a butterfly is (FFTKernels.h)
+    int radix;             ///< odd: timed on radix^2 2^k points
+    FFTTransform transform;
+    bool inPlace;
+    int (*prepare)(int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass);
+    int kernel;
+};
+
+static const FFTKernelInfo FFTKernelsList[] = {
+    {"kiss", "kf_bfly2", "radix-2", 2, FFTTransformComplex, true, FFTKernelsKissPrepare, 2},
+    {"kiss", "kf_bfly3", "radix-3", 3, FFTTransformComplex, true, FFTKernelsKissPrepare, 3},
+    {"kiss", "kf_bfly4", "radix-4", 4, FFTTransformComplex, true, FFTKernelsKissPrepare, 4},
+    {"kiss", "kf_bfly5", "radix-5", 5, FFTTransformComplex, true, FFTKernelsKissPrepare, 5},
+    {"kiss", "kf_bfly_generic", "radix-7", FFTKernelsKissRadixGeneric, FFTTransformComplex, true,
+     FFTKernelsKissPrepare, FFTKernelsKissRadixGeneric},
+    {"pffft", "passf4_ps", "radix-4", 4, FFTTransformComplex, false, FFTKernelsPFFFTPrepare, FFTKernelsPFFFTPassf4},
+    {"pffft", "passf5_ps", "radix-5", 5, FFTTransformComplex, false, FFTKernelsPFFFTPrepare, FFTKernelsPFFFTPassf5},
+    {"pffft", "radf4_ps", "radix-4", 4, FFTTransformReal, false, FFTKernelsPFFFTPrepare, FFTKernelsPFFFTRadf4},
+    {"pffft", "radb4_ps", "radix-4", 4, FFTTransformReal, false, FFTKernelsPFFFTPrepare, FFTKernelsPFFFTRadb4},
+    {"ckfft", "fft_default/4", "radix-4", 4, FFTTransformComplex, false, FFTKernelsCkFFTPrepare, 4},
+    {"ckfft", "fft_default/8", "8-point", 8, FFTTransformComplex, false, FFTKernelsCkFFTPrepare, 8},
+    {"nsfft", "srButForward16", "radix-2", 2, FFTTransformComplex, true, FFTKernelsNSFFTBestPrepare,
+     FFTKernelsNSFFTButForward16},
+    {"nsfft", "srButForward32", "radix-2", 2, FFTTransformComplex, true, FFTKernelsNSFFTBestPrepare,
+     FFTKernelsNSFFTButForward32},
+    {"nsfft", "bitReversalCobra", "point", 2, FFTTransformComplex, true, FFTKernelsNSFFTBestPrepare,
+     FFTKernelsNSFFTBitReversalCobra},
+    {"ne10", "mixed_radix_bfly", "radix-2", 2, FFTTransformComplex, false, FFTKernelsNe10Prepare, 0},
+};
+
+/// The length a kernel runs on for `length` of options, 0 if none.
+static int FFTKernelsLength(const FFTKernelInfo &info, int length) {
+    if (info.radix % 2 == 0) return length;
+    int n = info.radix * info.radix;
+    if (n > length) return 0;
+    while (n * 2 <= length) n *= 2;
+    return n;
+}
+
+
+int FFTKernelsRun(const FFTBenchOptions &options) {
+    int count = sizeof(FFTKernelsList) / sizeof(FFTKernelsList[0]);
+    std::vector<const FFTKernelInfo *> kernels;
+    for (int k = 0; k < count; k++) {
+        const FFTKernelInfo &info = FFTKernelsList[k];
+        if (options.backends.empty() ||
+            std::find(options.backends.begin(), options.backends.end(), info.library) != options.backends.end()) {
+            kernels.push_back(&info);
+        }
+    }
+    if (kernels.empty()) {
+        fprintf(stderr, "no kernels of the selected backends (kiss, pffft, ckfft, nsfft, ne10)\n");
+        return 1;
+    }
+    FFTBenchPrintEnvironment();
+    FFTTimerOptions timer = options.timer;
+    timer.cycles = true;
+    bool cycles = FFTTimerHasCycles();
+    printf("kernels: one pass of every call in a stage, ns%s per butterfly\n", cycles ? " and TSC cycles" : "");
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        printf("%d-------\n", lengths[l]);
+        printf("%-6s %-17s %-5s %6s %7s %-8s %8s %12s %9s %9s\n", "", "kernel", "stage", "n", "stride", "unit",
+               "bflies", "ns/pass", "ns/bfly", cycles ? "cyc/bfly" : "");
+        for (size_t k = 0; k < kernels.size(); k++) {
+            const FFTKernelInfo &info = *kernels[k];
+            int length = FFTKernelsLength(info, lengths[l]);
+            if (!length) continue;
+            std::string label = std::string(info.library) + ":";
+            long firstStride = -1;
+            for (int st = FFTKernelStageFirst; st <= FFTKernelStageLast; st++) {
+                FFTKernelPass pass = FFTKernelPass();
+                if (!info.prepare(info.kernel, length, (FFTKernelStage)st, &pass)) continue;
+                if (st == FFTKernelStageLast && pass.stride == firstStride) { // one stage only
+                    pass.release(&pass);
+                    continue;
+                }
+                firstStride = pass.stride;
+
+                long batch = options.points / length / options.timer.trials;
+                FFTTiming timing = FFTTimerMeasure(timer, batch, [&](long n) { pass.run(&pass, n); });
+                double ns = timing.ns.median / pass.butterflies;
+                printf("%-6s %-17s %-5s %6d %7ld %-8s %8ld %12.1f %9.3f", label.c_str(), info.name, pass.stage,
+                       length, pass.stride, info.unit, pass.butterflies, timing.ns.median, ns);
+                if (timing.cycles.count) printf(" %9.2f", timing.cycles.median / pass.butterflies);
+                printf("\n");
+
+                FFTRecord record = FFTRecord();
+                record.backend = info.library;
+                record.length = length;
+                record.precision = FFTPrecisionFloat;
+                record.transform = info.transform;
+                record.inPlace = info.inPlace;
+                record.direction = info.name;
+                record.threads = 1;
+                record.status = FFTBenchStatusOK;
+                record.timing = timing;
+                record.peakBytes = -1;
+                record.stage = pass.stage;
+                record.stride = pass.stride;
+                record.butterflies = pass.butterflies;
+                records.push_back(record);
+                pass.release(&pass);
+            }
+        }
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
@@ -0,0 +1,47 @@
+//
+//  FFTKernels.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTKernels__
+#define __FFTBench__FFTKernels__
+
+#include "FFTBench.h"
+
+/*
+ Butterfly kernels of the vendored libraries, timed alone. A whole transform
+ mixes radices, twiddle strides and bit reversal; here one pass of one kernel
+ (every call it gets in one stage of a real plan, Kernels/FFTKernelsShim.h)
+ is repeated on its own
+
+    kiss     kf_bfly2/3/4/5, kf_bfly_generic (radix 7)
+    pffft    passf4_ps, passf5_ps (complex), radf4_ps, radb4_ps (real)
+    ckfft    fft_default count == 4 and count == 8 leaves
+    nsfft    srButForward16/32, bitReversalCobraInplace (best float mode)
+    ne10     ne10_mixed_radix_butterfly_float32_c (the whole transform)
+
+    ./FFTBench --kernels
+    ./FFTBench --kernels -b kiss --min-log2 10 --max-log2 16
+
+ in its first and last stage where the plan has both: the first runs many
+ short sub-transforms with a long twiddle stride, the last one wide
+ butterflies with stride 1. Odd radices run on r^2 2^k points, the largest not
+ above each length of options. The result is ns and time stamp counter cycles
+ per butterfly, in the unit of the kernel's row:
+
+    radix-r   one radix-r butterfly (kiss, pffft, the ckfft count == 4 leaf)
+    8-point   one 8-point leaf DFT (ckfft count == 8)
+    radix-2   radix-2 equivalents, N/2 per log2 level (nsfft split radix, ne10)
+    point     one point moved (bit reversal)
+
+ Only float kernels are timed; data is zero, floating point throughput does
+ not depend on it outside subnormals, and the in-place kernels repeat on their
+ own output without overflowing.
+ */
+
+/// Run the kernel benchmark over the lengths of options, return the number of failures.
+int FFTKernelsRun(const FFTBenchOptions &options);
+
+#endif /* defined(__FFTBench__FFTKernels__) */
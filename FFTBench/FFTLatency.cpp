@@ -0,0 +1,208 @@
+//
+//  FFTLatency.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTLatency.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+#include "FFTAlloc.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#define FFTLATENCY_HAS_RUSAGE 1
+#endif
+
+#define FFTLatencyDefaultCalls 100000
+#define FFTLatencyBuckets 40
+
+
+/// Minor + major page faults of this thread so far, -1 if unknown.
+static long FFTLatencyPageFaults(void) {
+#if FFTLATENCY_HAS_RUSAGE
+    struct rusage usage;
+#if defined(RUSAGE_THREAD)
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) return -1;
+#else
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#endif
+    return usage.ru_minflt + usage.ru_majflt;
+#else
+    return -1;
+#endif
+}
+
+
+static void FFTLatencyLoad(FFTBackend *backend, const double *data_real, const double *data_imag, int length) {
+    FFTLayout layout = backend->layout();
+    FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+}
+
+/// one forward+inverse pair, for FFTAllocStackUse
+static void FFTLatencyRoundtrip(void *context) {
+    FFTBackend *backend = (FFTBackend *)context;
+    backend->forward();
+    backend->inverse();
+}
+
+
+/// Octave buckets: bucket k counts samples in [2^k, 2^(k+1)) ns.
+static std::vector<long> FFTLatencyHistogram(const std::vector<double> &samples) {
+    std::vector<long> histogram(FFTLatencyBuckets, 0);
+    for (size_t i = 0; i < samples.size(); i++) {
+        int k = 0;
+        double ns = samples[i];
+        while (ns >= 2 && k < FFTLatencyBuckets - 1) {
+            ns *= 0.5;
+            k++;
+        }
+        histogram[k]++;
+    }
+    return histogram;
+}
+
+static void FFTLatencyPrintHistogram(const char *label, const std::vector<long> &histogram) {
+    printf("%-6s hist  ", label);
+    for (size_t k = 0; k < histogram.size(); k++) {
+        if (!histogram[k]) continue;
+        double ns = (double)(1LL << k);
+        if (ns < 1000) printf(" [%gns %ld]", ns, histogram[k]);
+        else if (ns < 1e6) printf(" [%.3gus %ld]", ns / 1e3, histogram[k]);
+        else printf(" [%.3gms %ld]", ns / 1e6, histogram[k]);
+    }
+    printf("\n");
+}
+
+
+/// Time `calls` single forward+inverse pairs, false if setup failed.
+static bool FFTLatencyMeasure(const FFTBackendInfo *info, int length, long calls,
+                              const double *data_real, const double *data_imag, FFTRecord &record) {
+    FFTBackend *backend = info->create();
+    if (!backend->setup(length)) {
+        backend->teardown();
+        delete backend;
+        return false;
+    }
+    record.inPlace = FFTLayoutIsInPlace(backend->layout());
+
+    // the warmup runs the timed body too, so the clock, the alloc hooks and getrusage fault in before it;
+    // faults are read around each pair only, the input load and the bookkeeping fault on their own
+    bool hasFaults = FFTLatencyPageFaults() >= 0;
+    long faults = 0;
+    auto pair = [&](void) {
+        FFTLatencyLoad(backend, data_real, data_imag, length);
+        long before = hasFaults ? FFTLatencyPageFaults() : 0;
+        FFTAllocTrack(true);
+        uint64_t t0 = FFTTimerNanoseconds();
+        backend->forward();
+        backend->inverse();
+        uint64_t t1 = FFTTimerNanoseconds();
+        FFTAllocTrack(false);
+        if (hasFaults) faults += FFTLatencyPageFaults() - before;
+        return (double)(t1 - t0);
+    };
+    long warmup = std::max(calls / 10, 1L);
+    for (long i = 0; i < warmup; i++) pair();
+
+    std::vector<double> samples(calls);
+    FFTAllocCount allocs = FFTAllocRead();
+    faults = 0;
+    for (long i = 0; i < calls; i++) samples[i] = pair();
+    record.hasAllocs = FFTAllocAvailable();
+    record.allocsPerCall = (double)(FFTAllocRead().calls - allocs.calls) / calls;
+    record.allocBytes = -1;
+    record.planBytes = -1;
+    record.peakBytes = -1;
+    record.pageFaults = hasFaults ? faults : -1;
+
+    record.stackBytes = FFTAllocStackUse(FFTLatencyRoundtrip, backend);
+    record.hasStack = record.stackBytes >= 0;
+
+    record.timing.batch = 1;
+    record.timing.ns = FFTStatsCompute(samples);
+    record.histogram = FFTLatencyHistogram(samples);
+
+    backend->teardown();
+    delete backend;
+    return true;
+}
+
+
+int FFTLatencyRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    if (options.backends.empty()) { // in-place kiss_fft, opt-in in the sweep
+        const std::vector<FFTBackendInfo> &all = FFTBackendRegistry::backends();
+        for (size_t i = 0; i < all.size(); i++) {
+            if (all[i].transform != options.transform || all[i].precision != options.precision) continue;
+            if (!strcmp(all[i].name, "kiss-ip")) backends.push_back(&all[i]);
+        }
+    }
+    long calls = options.latencyCalls > 0 ? options.latencyCalls : FFTLatencyDefaultCalls;
+    FFTBenchPrintEnvironment();
+    printf("latency: %ld single fft+ifft pairs per cell%s\n", calls,
+           FFTAllocAvailable() ? "" : ", allocations not counted in this build");
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        int length = lengths[l];
+        printf("%d-------\n", length);
+
+        std::vector<double> data_real(length), data_imag(length);
+        FFTBenchGenerateInput(data_real.data(), data_imag.data(), length);
+
+        for (size_t b = 0; b < backends.size(); b++) {
+            const FFTBackendInfo *info = backends[b];
+            std::string label = std::string(info->name) + ":";
+            FFTBackend *probe = info->create();
+            bool supported = probe->supports(length);
+            delete probe;
+            if (!supported) continue;
+
+            FFTRecord record = FFTRecord();
+            record.backend = info->name;
+            record.length = length;
+            record.precision = info->precision;
+            record.transform = info->transform;
+            record.direction = "roundtrip";
+            record.threads = 1;
+            record.premarshal = true;
+            record.hasHotPath = true;
+            if (!FFTLatencyMeasure(info, length, calls, data_real.data(), data_imag.data(), record)) {
+                printf("%-6s setup failed\n", label.c_str());
+                record.status = FFTBenchStatusSetupFailed;
+                record.hasHotPath = false;
+                records.push_back(record);
+                failures++;
+                continue;
+            }
+            record.status = FFTBenchStatusOK;
+            records.push_back(record);
+
+            const FFTStats &ns = record.timing.ns;
+            printf("%-6s lat    p50 %9.1f  p99 %9.1f  p99.9 %9.1f  max %9.1f ns", label.c_str(),
+                   ns.median, ns.p99, ns.p999, ns.max);
+            if (record.hasAllocs) printf("  allocs %.2f", record.allocsPerCall);
+            if (record.pageFaults >= 0) printf("  faults %ld", record.pageFaults);
+            if (record.hasStack) printf("  stack %.1f KB", record.stackBytes / 1024.0);
+            if (record.allocsPerCall > 0) printf("  ! allocates");
+            if (record.pageFaults > 0) printf("  ! page faults");
+            printf("\n");
+            FFTLatencyPrintHistogram(label.c_str(), record.histogram);
+        }
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
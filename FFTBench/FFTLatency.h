@@ -0,0 +1,35 @@
+//
+//  FFTLatency.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTLatency__
+#define __FFTBench__FFTLatency__
+
+#include "FFTBench.h"
+
+/*
+ Real-time latency: every forward+inverse pair is timed on its own
+
+    for() {
+      input();
+      t0; fft(); ifft(); t1;
+    }
+
+ and the samples go into an octave histogram with p50/p99/p99.9/max. The hot
+ path is also checked for things an audio callback must not do:
+
+    allocs:  heap allocations per pair (FFTAlloc, statically linked code
+             only), e.g. kiss_fft's KISS_FFT_TMP_ALLOC in kf_bfly_generic
+             and in every in-place call (kiss-ip, added to the defaults)
+    faults:  minor + major page faults of the pairs (getrusage)
+    stack:   bytes of stack one pair uses (FFTAllocStackUse), e.g. pffft's
+             VLA scratch when no work buffer is passed
+ */
+
+/// Run the latency benchmark over the lengths of options, return the number of failures.
+int FFTLatencyRun(const FFTBenchOptions &options);
+
+#endif /* defined(__FFTBench__FFTLatency__) */
@@ -0,0 +1,193 @@
+//
+//  FFTPlanner.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTPlanner.h"
+#include "FFTBench.h"
+#include "FFTBaseline.h"
+#include "FFTTimer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <mutex>
+
+#define FFTPlannerTrials 5
+
+
+static std::mutex FFTPlannerLock;
+static std::string FFTPlannerPath;
+static bool FFTPlannerPathSet = false;
+static bool FFTPlannerLoaded = false;
+static std::map<std::string, std::string> FFTPlannerWisdom;   ///< key -> backend name
+
+
+const char *FFTPlannerWisdomPath(void) {
+    if (!FFTPlannerPathSet) {
+        const char *env = getenv("FFTBENCH_WISDOM");
+        const char *home = getenv("HOME");
+        if (env) FFTPlannerPath = env;
+        else if (home) FFTPlannerPath = std::string(home) + "/.fftbench-wisdom";
+        FFTPlannerPathSet = true;
+    }
+    return FFTPlannerPath.c_str();
+}
+
+void FFTPlannerSetWisdomPath(const char *path) {
+    std::lock_guard<std::mutex> guard(FFTPlannerLock);
+    FFTPlannerPath = path ? path : "";
+    FFTPlannerPathSet = true;
+    FFTPlannerLoaded = false;
+    FFTPlannerWisdom.clear();
+}
+
+
+static const char *FFTPlannerTrackName(FFTTransform transform, FFTPrecision precision) {
+    if (transform == FFTTransformReal) return precision == FFTPrecisionDouble ? "real-double" : "real-float";
+    return precision == FFTPrecisionDouble ? "complex-double" : "complex-float";
+}
+
+static std::string FFTPlannerKey(const char *track, int length) {
+    char key[64];
+    snprintf(key, sizeof(key), "%s %d", track, length);
+    return key;
+}
+
+/// wisdom lines: "<fingerprint> <track> <length> <backend> <ns per fft+ifft>", other machines skipped
+static void FFTPlannerLoad(const std::string &fingerprint) {
+    FFTPlannerLoaded = true;
+    FILE *file = *FFTPlannerWisdomPath() ? fopen(FFTPlannerWisdomPath(), "r") : NULL;
+    if (!file) return;
+    char line[512], machine[256], track[32], backend[64];
+    int length;
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%255s %31s %d %63s", machine, track, &length, backend) != 4) continue;
+        if (fingerprint != machine) continue;
+        FFTPlannerWisdom[FFTPlannerKey(track, length)] = backend; // later lines win
+    }
+    fclose(file);
+}
+
+static void FFTPlannerStore(const std::string &fingerprint, const char *track, int length,
+                            const char *backend, double ns) {
+    if (!*FFTPlannerWisdomPath()) return;
+    FILE *file = fopen(FFTPlannerWisdomPath(), "a");
+    if (!file) {
+        fprintf(stderr, "cannot write wisdom %s\n", FFTPlannerWisdomPath());
+        return;
+    }
+    fprintf(file, "%s %s %d %s %.1f\n", fingerprint.c_str(), track, length, backend, ns);
+    fclose(file);
+}
+
+
+/// Median ns of one fft+ifft pair, -1 if setup fails or either transform is wrong.
+static double FFTPlannerMeasure(const FFTBackendInfo *info, int length, const double *data_real,
+                                const double *data_imag, const double *idft_real, const double *idft_imag) {
+    FFTBackend *backend = info->create();
+    double ns = -1;
+    if (backend->setup(length)) {
+        FFTLayout layout = backend->layout();
+        std::vector<double> real(length), imag(length);
+        FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+        backend->forward();
+        FFTSpectrumStore(layout, real.data(), imag.data(), length, 1.0 / layout.forwardScale);
+        FFTError error = FFTErrorCompute(real.data(), imag.data(), idft_real, idft_imag,
+                                         FFTLayoutSpectrumBins(layout, length));
+
+        // the round trip back from that spectrum, so a wrong inverseScale or packing never becomes wisdom
+        backend->inverse();
+        FFTBufferStore(layout.input, layout.precision, real.data(), imag.data(), length,
+                       1.0 / (length * layout.inverseScale));
+        FFTError inverseError = FFTErrorCompute(real.data(), imag.data(), data_real, data_imag, length);
+
+        double tolerance = FFTBenchTolerance(layout.precision);
+        if (error.rms <= tolerance && inverseError.rms <= tolerance) { // false for NaN
+            FFTBufferImage image;
+            FFTBufferLoad(layout.input, layout.precision, data_real, data_imag, length);
+            image.capture(layout.input, layout.precision, length);
+            FFTTimerOptions timer;
+            timer.trials = FFTPlannerTrials;
+            timer.budget = FFTPlannerSeconds;
+            FFTTiming timing = FFTTimerMeasure(timer, 1, [&](long n) {
+                for (long r = 0; r < n; r++) {
+                    image.restore();
+                    backend->forward();
+                    backend->inverse();
+                }
+            });
+            ns = timing.ns.median;
+        }
+    }
+    backend->teardown();
+    delete backend;
+    return ns;
+}
+
+/// Time every candidate of the track, NULL if none supports the length.
+static const FFTBackendInfo *FFTPlannerPlan(int length, FFTTransform transform, FFTPrecision precision,
+                                            double *bestNs) {
+    std::vector<double> data_real(length), data_imag(length), idft_real(length), idft_imag(length);
+    FFTBenchGenerateInput(data_real.data(), data_imag.data(), length);
+    FFTReferenceDFT(data_real.data(), data_imag.data(), idft_real.data(), idft_imag.data(), length, -1);
+
+    const FFTBackendInfo *best = NULL;
+    const std::vector<FFTBackendInfo> &all = FFTBackendRegistry::backends();
+    for (size_t i = 0; i < all.size(); i++) {
+        const FFTBackendInfo *info = &all[i];
+        if (info->transform != transform || info->precision != precision || info->optIn) continue;
+        FFTBackend *probe = info->create();
+        bool supported = probe->supports(length);
+        delete probe;
+        if (!supported) continue;
+
+        double ns = FFTPlannerMeasure(info, length, data_real.data(), data_imag.data(),
+                                      idft_real.data(), idft_imag.data());
+        if (ns > 0 && (!best || ns < *bestNs)) {
+            best = info;
+            *bestNs = ns;
+        }
+    }
+    return best;
+}
+
+
+const FFTBackendInfo *FFTPlannerChoose(int length, FFTTransform transform, FFTPrecision precision) {
+    std::lock_guard<std::mutex> guard(FFTPlannerLock);
+    std::string fingerprint = FFTBaselineFingerprint(FFTMachineInfoGet());
+    if (!FFTPlannerLoaded) FFTPlannerLoad(fingerprint);
+
+    const char *track = FFTPlannerTrackName(transform, precision);
+    std::string key = FFTPlannerKey(track, length);
+    std::map<std::string, std::string>::const_iterator known = FFTPlannerWisdom.find(key);
+    if (known != FFTPlannerWisdom.end()) {
+        const FFTBackendInfo *info = FFTBackendRegistry::find(known->second.c_str());
+        if (info && info->transform == transform && info->precision == precision) return info;
+    }
+
+    double ns = 0;
+    const FFTBackendInfo *best = FFTPlannerPlan(length, transform, precision, &ns);
+    if (!best) return NULL;
+    printf("plan   %s %d: %s, %.1f ns per fft+ifft\n", track, length, best->name, ns);
+    FFTPlannerWisdom[key] = best->name;
+    FFTPlannerStore(fingerprint, track, length, best->name, ns);
+    return best;
+}
+
+
+FFTBackend *FFTPlannerCreate(int length, FFTTransform transform, FFTPrecision precision) {
+    const FFTBackendInfo *info = FFTPlannerChoose(length, transform, precision);
+    if (!info) return NULL;
+    FFTBackend *backend = info->create();
+    if (!backend->setup(length)) {
+        backend->teardown();
+        delete backend;
+        return NULL;
+    }
+    return backend;
+}
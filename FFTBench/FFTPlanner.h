@@ -0,0 +1,52 @@
+//
+//  FFTPlanner.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTPlanner__
+#define __FFTBench__FFTPlanner__
+
+#include "FFTBackend.h"
+
+#include <string>
+
+/*
+ Meta-FFT over the vendored libraries, like FFTW wisdom but across libraries:
+
+    FFTBackend *fft = FFTPlannerCreate(1024, FFTTransformComplex, FFTPrecisionFloat);
+    for() {
+      load(fft->layout().input);
+      fft->forward();
+      fft->inverse();
+    }
+    fft->teardown();
+    delete fft;
+
+ The first request of a (transform, precision, length) sets up every registered
+ backend of that track that supports the length (opt-in ones excluded), checks
+ its forward transform against the reference, and times fft+ifft pairs for
+ about FFTPlannerSeconds each. The fastest correct one is appended to the
+ wisdom file, keyed by the machine fingerprint of FFTBaseline, so later runs
+ on the same host (and build) reuse the decision without timing anything.
+ The backend keeps its own layout, so callers go through FFTBufferLoad/Store.
+ */
+
+/// Time spent timing one candidate, seconds.
+#define FFTPlannerSeconds 0.02
+
+/// Where decisions are kept: $FFTBENCH_WISDOM, or ~/.fftbench-wisdom.
+const char *FFTPlannerWisdomPath(void);
+
+/// Use another wisdom file, "" keeps decisions in memory only.
+void FFTPlannerSetWisdomPath(const char *path);
+
+/// The fastest backend of the track for `length`, planned now unless known;
+/// NULL if no backend of the track supports the length.
+const FFTBackendInfo *FFTPlannerChoose(int length, FFTTransform transform, FFTPrecision precision);
+
+/// The chosen backend, set up for `length`; NULL if none supports it.
+FFTBackend *FFTPlannerCreate(int length, FFTTransform transform, FFTPrecision precision);
+
+#endif /* defined(__FFTBench__FFTPlanner__) */
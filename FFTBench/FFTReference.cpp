@@ -0,0 +1,194 @@
+//
+//  FFTReference.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTReference.h"
+#include "FFTSizes.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+typedef long double FFTReal;
+
+static const FFTReal FFTReferencePi = 3.141592653589793238462643383279502884L;
+static const int FFTReferenceBlock = 1 << 14; ///< 512 KB of long double complex
+
+
+struct FFTComplexL {
+    FFTReal re;
+    FFTReal im;
+};
+
+
+/// exp(sign * 2pi i k / n) for k < n/2, from n/8 sinl/cosl pairs and the octant symmetries
+static void FFTReferenceTwiddles(std::vector<FFTComplexL> &w, int n, int sign) {
+    int half = n / 2, quarter = n / 4;
+    w.resize(half > 0 ? half : 1);
+    if (n < 8) {
+        for (int k = 0; k < half; k++) {
+            FFTReal angle = 2 * FFTReferencePi * k / n;
+            w[k].re = cosl(angle);
+            w[k].im = sinl(angle);
+        }
+    } else {
+        for (int k = 0; k <= n / 8; k++) { // first octant, mirrored into the second
+            FFTReal angle = 2 * FFTReferencePi * k / n;
+            FFTReal c = cosl(angle), s = sinl(angle);
+            w[k].re = c;
+            w[k].im = s;
+            w[quarter - k].re = s;
+            w[quarter - k].im = c;
+        }
+        for (int k = 0; k < quarter; k++) { // second quadrant, rotated by pi/2
+            w[quarter + k].re = -w[k].im;
+            w[quarter + k].im = w[k].re;
+        }
+    }
+    if (sign < 0) {
+        for (int k = 0; k < half; k++) w[k].im = -w[k].im;
+    }
+}
+
+
+/// one radix-2 pass over `n` points with butterflies `len` apart, `w` holds the len/2 twiddles
+static void FFTReferenceStage(FFTComplexL *x, int n, int len, const FFTComplexL *w) {
+    int h = len / 2;
+    for (int base = 0; base < n; base += len) {
+        FFTComplexL *a = x + base, *b = a + h;
+        for (int k = 0; k < h; k++) {
+            const FFTComplexL &c = w[k];
+            FFTReal tr = b[k].re * c.re - b[k].im * c.im;
+            FFTReal ti = b[k].re * c.im + b[k].im * c.re;
+            b[k].re = a[k].re - tr;
+            b[k].im = a[k].im - ti;
+            a[k].re += tr;
+            a[k].im += ti;
+        }
+    }
+}
+
+
+/// in-place radix-2 transform of `n` (power of two) points
+static void FFTReferenceRadix2(FFTComplexL *x, int n, int sign) {
+    for (int i = 1, j = 0; i < n; i++) { // bit reversal
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            FFTComplexL t = x[i]; x[i] = x[j]; x[j] = t;
+        }
+    }
+
+    // twiddles of the last stage; stage `len` uses every (n/len)th, copied out so the
+    // butterflies read them sequentially instead of one page apart
+    std::vector<FFTComplexL> w;
+    FFTReferenceTwiddles(w, n, sign);
+
+    // stages up to `block` points run block by block while the block is in cache
+    int block = n < FFTReferenceBlock ? n : FFTReferenceBlock;
+    std::vector<FFTComplexL> blockTwiddles(block);  // stage len at offset len/2
+    for (int len = 2; len <= block; len <<= 1) {
+        for (int k = 0; k < len / 2; k++) blockTwiddles[len / 2 + k] = w[(long)k * (n / len)];
+    }
+    for (int start = 0; start < n; start += block) {
+        for (int len = 2; len <= block; len <<= 1) {
+            FFTReferenceStage(x + start, block, len, blockTwiddles.data() + len / 2);
+        }
+    }
+
+    std::vector<FFTComplexL> stageTwiddles;
+    for (int len = block * 2; len <= n; len <<= 1) {
+        stageTwiddles.resize(len / 2);
+        for (int k = 0; k < len / 2; k++) stageTwiddles[k] = w[(long)k * (n / len)];
+        FFTReferenceStage(x, n, len, stageTwiddles.data());
+    }
+}
+
+
+/// Bluestein: nk = (n^2 + k^2 - (k-n)^2) / 2 turns the DFT into a convolution with a chirp
+static void FFTReferenceBluestein(FFTComplexL *x, int n, int sign) {
+    int m = 1;
+    while (m < 2 * n - 1) m <<= 1;
+
+    // chirp w[j] = exp(sign * pi i j^2 / n), j^2 reduced mod 2n so the angle stays exact
+    std::vector<FFTComplexL> w(n);
+    for (int j = 0; j < n; j++) {
+        int64_t sq = (int64_t)j * j % (2 * (int64_t)n);
+        FFTReal angle = sign * FFTReferencePi * sq / n;
+        w[j].re = cosl(angle);
+        w[j].im = sinl(angle);
+    }
+
+    FFTComplexL zero = {0, 0};
+    std::vector<FFTComplexL> a(m, zero), b(m, zero);
+    for (int j = 0; j < n; j++) { // a = x * w
+        a[j].re = x[j].re * w[j].re - x[j].im * w[j].im;
+        a[j].im = x[j].re * w[j].im + x[j].im * w[j].re;
+    }
+    b[0].re = w[0].re;
+    b[0].im = -w[0].im;
+    for (int j = 1; j < n; j++) { // b = conj(w), symmetric around 0
+        b[j].re = b[m - j].re = w[j].re;
+        b[j].im = b[m - j].im = -w[j].im;
+    }
+
+    FFTReferenceRadix2(a.data(), m, -1);
+    FFTReferenceRadix2(b.data(), m, -1);
+    for (int j = 0; j < m; j++) {
+        FFTReal re = a[j].re * b[j].re - a[j].im * b[j].im;
+        FFTReal im = a[j].re * b[j].im + a[j].im * b[j].re;
+        a[j].re = re;
+        a[j].im = im;
+    }
+    FFTReferenceRadix2(a.data(), m, 1);
+
+    for (int k = 0; k < n; k++) { // X = w * (a conv b) / m
+        FFTReal cr = a[k].re / m, ci = a[k].im / m;
+        x[k].re = cr * w[k].re - ci * w[k].im;
+        x[k].im = cr * w[k].im + ci * w[k].re;
+    }
+}
+
+
+void FFTReferenceDFT(const double *inReal, const double *inImag, double *outReal, double *outImag,
+                     int length, int sign) {
+    if (length <= 0) return;
+    std::vector<FFTComplexL> x(length);
+    for (int i = 0; i < length; i++) {
+        x[i].re = inReal[i];
+        x[i].im = inImag[i];
+    }
+    if (FFTSizeIsPow2(length)) FFTReferenceRadix2(x.data(), length, sign);
+    else FFTReferenceBluestein(x.data(), length, sign);
+    for (int i = 0; i < length; i++) {
+        outReal[i] = (double)x[i].re;
+        outImag[i] = (double)x[i].im;
+    }
+}
+
+
+FFTError FFTErrorCompute(const double *real, const double *imag,
+                         const double *expectReal, const double *expectImag, int length) {
+    long double diff = 0, norm = 0;
+    double maxDiff = 0, maxNorm = 0;
+    for (int i = 0; i < length; i++) {
+        // long double squares: subnormal doubles (decay input of the double track) would underflow
+        long double dr = (long double)real[i] - expectReal[i], di = (long double)imag[i] - expectImag[i];
+        long double er = expectReal[i], ei = expectImag[i];
+        double d = (double)sqrtl(dr * dr + di * di);
+        double e = (double)sqrtl(er * er + ei * ei);
+        diff += dr * dr + di * di;
+        norm += er * er + ei * ei;
+        if (d > maxDiff || d != d) maxDiff = d; // NaN sticks
+        if (e > maxNorm) maxNorm = e;
+    }
+
+    FFTError error;
+    error.rms = norm > 0 ? (double)sqrtl(diff / norm) : (double)sqrtl(diff);
+    error.max = maxNorm > 0 ? maxDiff / maxNorm : maxDiff;
+    return error;
+}
@@ -0,0 +1,37 @@
+//
+//  FFTReference.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTReference__
+#define __FFTBench__FFTReference__
+
+/*
+ Reference transform used to validate the backends, replaces the O(N^2)
+ mydftd of myfft.c.
+
+    power of two:   iterative radix-2 in long double
+    other lengths:  Bluestein, through a power-of-two convolution
+
+ Every twiddle is computed directly with sinl/cosl (no recurrence), and the
+ Bluestein chirp uses n*n mod 2N in integers, so the only rounding is in the
+ butterflies. Cost is O(N log N) for every length: 2^24 points in seconds.
+ */
+
+/// Unnormalized DFT of `length` complex samples, sign -1 forward, +1 inverse.
+void FFTReferenceDFT(const double *inReal, const double *inImag, double *outReal, double *outImag,
+                     int length, int sign);
+
+
+/// Error of a result against the reference.
+struct FFTError {
+    double rms;   ///< sqrt(sum |y - ref|^2 / sum |ref|^2)
+    double max;   ///< max |y - ref| / max |ref|, relative to the peak, not per bin
+};
+
+FFTError FFTErrorCompute(const double *real, const double *imag,
+                         const double *expectReal, const double *expectImag, int length);
+
+#endif /* defined(__FFTBench__FFTReference__) */
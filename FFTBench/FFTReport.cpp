@@ -0,0 +1,496 @@
+//
+//  FFTReport.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTReport.h"
+#include "FFTAlloc.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <thread>
+#include "nsfft.h"
+
+#if !defined(_WIN32)
+#include <sys/utsname.h>
+#endif
+
+#ifndef FFTBENCH_BUILD_FLAGS
+#define FFTBENCH_BUILD_FLAGS ""
+#endif
+#ifndef FFTBENCH_BUILD_TYPE
+#define FFTBENCH_BUILD_TYPE ""
+#endif
+
+
+static std::string FFTReportTrim(const char *str) {
+    std::string s = str ? str : "";
+    size_t begin = s.find_first_not_of(" \t\n");
+    size_t end = s.find_last_not_of(" \t\n");
+    return begin == std::string::npos ? std::string() : s.substr(begin, end - begin + 1);
+}
+
+FFTMachineInfo FFTMachineInfoGet(void) {
+    FFTMachineInfo info;
+    info.processor = FFTReportTrim(SIMDBase_getProcessorNameString());
+    info.arch = FFTBenchArchitecture();
+
+#if !defined(_WIN32)
+    struct utsname name;
+    if (uname(&name) == 0) info.os = std::string(name.sysname) + " " + name.release;
+#else
+    info.os = "Windows";
+#endif
+
+#if defined(__clang__)
+    info.compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    info.compiler = std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    char msc[32];
+    snprintf(msc, sizeof(msc), "msvc %d", _MSC_VER);
+    info.compiler = msc;
+#endif
+    info.compiler = FFTReportTrim(info.compiler.c_str());
+    info.flags = FFTReportTrim(FFTBENCH_BUILD_FLAGS);
+    info.buildType = FFTBENCH_BUILD_TYPE;
+
+    char stamp[32];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    info.timestamp = stamp;
+
+    info.cpus = (int)std::thread::hardware_concurrency();
+    info.cacheLineBytes = SIMDBase_sizeOfCachelineInByte();
+    info.dataCacheBytes = SIMDBase_sizeOfDataCacheInByte();
+    return info;
+}
+
+
+void FFTReportAddResults(const std::vector<FFTBenchResult> &results, std::vector<FFTRecord> &records) {
+    static const char *directions[] = {"load", "fwd", "inv", "store", "fwd+load", "inv+load"};
+    for (size_t i = 0; i < results.size(); i++) {
+        const FFTBenchResult &result = results[i];
+        if (result.status == FFTBenchStatusUnsupported) continue;
+        const FFTTiming *timings[] = {&result.load, &result.forward, &result.inverse, &result.store,
+                                      &result.forwardReload, &result.inverseReload};
+        for (int d = 0; d < 6; d++) {
+            if (d >= 4 && timings[d]->ns.count == 0) continue; // --premarshal, or never timed
+            FFTRecord record = FFTRecord();
+            record.backend = result.backend;
+            record.length = result.length;
+            record.precision = result.precision;
+            record.transform = result.transform;
+            record.inPlace = result.inPlace;
+            record.direction = directions[d];
+            record.threads = 1;
+            record.premarshal = d == 1 || d == 2;
+            record.status = result.status;
+            record.timing = *timings[d];
+            if (d == 1 || d == 2) {
+                record.error = d == 1 ? result.forwardError : result.inverseError;
+                record.hasCounters = result.hasCounters;
+                record.counters = d == 1 ? result.forwardCounters : result.inverseCounters;
+                record.hasEnergy = result.hasEnergy;
+                record.energy = d == 1 ? result.forwardEnergy : result.inverseEnergy;
+                record.hasAllocs = result.hasMemory && FFTAllocAvailable();
+                record.allocsPerCall = result.allocsPerCall;
+                record.allocBytes = result.setupBytes;
+                record.planBytes = result.planBytes;
+                record.peakBytes = result.peakBytes;
+                record.hasStack = result.hasMemory && result.stackBytes >= 0;
+                record.stackBytes = result.stackBytes;
+            }
+            records.push_back(record);
+        }
+    }
+}
+
+
+static const char *FFTReportStatusName(FFTBenchStatus status) {
+    switch (status) {
+        case FFTBenchStatusOK: return "ok";
+        case FFTBenchStatusUnsupported: return "unsupported";
+        case FFTBenchStatusSetupFailed: return "setup-failed";
+        case FFTBenchStatusInvalid: return "invalid";
+        case FFTBenchStatusMemoryLimit: return "memory-limit";
+    }
+    return "";
+}
+
+static double FFTReportMPointsPerSecond(const FFTRecord &record) {
+    if (record.timing.ns.count == 0 || record.timing.ns.median <= 0) return 0;
+    return 1e9 / record.timing.ns.median / 1024.0 / 1024.0 * record.length; // the M/s of the original FFTRun
+}
+
+/// Nominal flops of one timed call of the record, 0 for the load/store/setup phases.
+static double FFTReportFlops(const FFTRecord &record) {
+    double flops = FFTRooflineFlops(record.length, record.transform);
+    if (!strcmp(record.direction, "fwd") || !strcmp(record.direction, "inv")) return flops;
+    if (!strcmp(record.direction, "roundtrip")) return 2 * flops;
+    return 0;
+}
+
+/// Nominal bytes of one timed call, as FFTReportFlops.
+static double FFTReportBytes(const FFTRecord &record) {
+    double calls = FFTReportFlops(record) / FFTRooflineFlops(record.length, record.transform);
+    return calls * FFTRooflineBytes(record.length, record.transform, record.precision);
+}
+
+/// GFLOPS of a timed or throughput record, 0 if it has no rate.
+static double FFTReportGflops(const FFTRecord &record) {
+    double flops = FFTReportFlops(record);
+    if (flops <= 0) return 0;
+    if (record.timing.ns.count && record.timing.ns.median > 0) return flops / record.timing.ns.median;
+    return record.mfftPerSecond * 1e-3 * FFTRooflineFlops(record.length, record.transform); // per transform
+}
+
+/// json string literal
+static std::string FFTReportQuote(const std::string &s) {
+    std::string out = "\"";
+    for (size_t i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char)c < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out += esc;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+/// json number, null for nan/inf
+static void FFTReportNumber(FILE *file, double value) {
+    if (value != value || value - value != 0) fprintf(file, "null");
+    else fprintf(file, "%.9g", value);
+}
+
+
+static bool FFTReportWriteJSON(const char *path, const FFTBenchOptions &options, const FFTMachineInfo &machine,
+                               const std::vector<FFTRecord> &records) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "{\n  \"machine\": {\n");
+    fprintf(file, "    \"processor\": %s,\n", FFTReportQuote(machine.processor).c_str());
+    fprintf(file, "    \"arch\": %s,\n", FFTReportQuote(machine.arch).c_str());
+    fprintf(file, "    \"os\": %s,\n", FFTReportQuote(machine.os).c_str());
+    fprintf(file, "    \"compiler\": %s,\n", FFTReportQuote(machine.compiler).c_str());
+    fprintf(file, "    \"flags\": %s,\n", FFTReportQuote(machine.flags).c_str());
+    fprintf(file, "    \"build_type\": %s,\n", FFTReportQuote(machine.buildType).c_str());
+    fprintf(file, "    \"timestamp\": %s,\n", FFTReportQuote(machine.timestamp).c_str());
+    fprintf(file, "    \"cpus\": %d,\n", machine.cpus);
+    fprintf(file, "    \"cache_line_bytes\": %d,\n", machine.cacheLineBytes);
+    fprintf(file, "    \"data_cache_bytes\": %d\n", machine.dataCacheBytes);
+    fprintf(file, "  },\n");
+
+    fprintf(file, "  \"options\": {\"points\": %ld, \"trials\": %d, \"warmup\": %ld, \"premarshal\": %s, "
+            "\"seconds\": %g, \"shared_setup\": %s, \"pin_threads\": %s},\n",
+            options.points, options.timer.trials, options.timer.warmup, options.premarshal ? "true" : "false",
+            options.seconds, options.sharedSetup ? "true" : "false", options.pinThreads ? "true" : "false");
+    if (options.roofline) {
+        const FFTRoofline &roofline = FFTRooflineMeasure(options.precision);
+        fprintf(file, "  \"roofline\": {\"precision\": \"%s\", \"isa\": \"%s\", \"gflops\": ",
+                options.precision == FFTPrecisionDouble ? "double" : "float", roofline.isa);
+        FFTReportNumber(file, roofline.gflops);
+        fprintf(file, ", \"l1_gb_s\": ");
+        FFTReportNumber(file, roofline.l1);
+        fprintf(file, ", \"cache_gb_s\": ");
+        FFTReportNumber(file, roofline.cache);
+        fprintf(file, ", \"dram_gb_s\": ");
+        FFTReportNumber(file, roofline.dram);
+        fprintf(file, ", \"cache_bytes\": %lld},\n", roofline.cacheBytes);
+    }
+
+    fprintf(file, "  \"records\": [");
+    for (size_t i = 0; i < records.size(); i++) {
+        const FFTRecord &r = records[i];
+        const FFTStats &ns = r.timing.ns;
+        fprintf(file, "%s\n    {\"backend\": %s, \"length\": %d, \"precision\": \"%s\", \"transform\": \"%s\", "
+                "\"layout\": \"%s\", \"direction\": \"%s\", \"threads\": %d, \"premarshal\": %s, "
+                "\"status\": \"%s\"",
+                i ? "," : "", FFTReportQuote(r.backend).c_str(), r.length,
+                r.precision == FFTPrecisionDouble ? "double" : "float",
+                r.transform == FFTTransformReal ? "real" : "complex",
+                r.inPlace ? "in-place" : "out-of-place", r.direction, r.threads, r.premarshal ? "true" : "false",
+                FFTReportStatusName(r.status));
+        if (r.cache) fprintf(file, ", \"cache\": \"%s\"", r.cache);
+        if (ns.count) {
+            fprintf(file, ",\n     \"ns\": {\"count\": %d, \"min\": ", ns.count);
+            FFTReportNumber(file, ns.min);
+            fprintf(file, ", \"median\": ");
+            FFTReportNumber(file, ns.median);
+            fprintf(file, ", \"p90\": ");
+            FFTReportNumber(file, ns.p90);
+            fprintf(file, ", \"p99\": ");
+            FFTReportNumber(file, ns.p99);
+            fprintf(file, ", \"p999\": ");
+            FFTReportNumber(file, ns.p999);
+            fprintf(file, ", \"max\": ");
+            FFTReportNumber(file, ns.max);
+            fprintf(file, ", \"mean\": ");
+            FFTReportNumber(file, ns.mean);
+            fprintf(file, ", \"ci_low\": ");
+            FFTReportNumber(file, ns.ciLow);
+            fprintf(file, ", \"ci_high\": ");
+            FFTReportNumber(file, ns.ciHigh);
+            fprintf(file, "}, \"batch\": %ld, \"mpoints_per_s\": ", r.timing.batch);
+            FFTReportNumber(file, FFTReportMPointsPerSecond(r));
+            if (r.timing.cycles.count) {
+                fprintf(file, ", \"cycles\": ");
+                FFTReportNumber(file, r.timing.cycles.median);
+            }
+        }
+        if (r.mfftPerSecond > 0) {
+            fprintf(file, ", \"mfft_per_s\": ");
+            FFTReportNumber(file, r.mfftPerSecond);
+        }
+        if (FFTReportGflops(r) > 0) {
+            fprintf(file, ", \"gflops\": ");
+            FFTReportNumber(file, FFTReportGflops(r));
+            fprintf(file, ", \"flops\": %.0f, \"bytes\": %.0f", FFTReportFlops(r), FFTReportBytes(r));
+        }
+        if (!strcmp(r.direction, "fwd") || !strcmp(r.direction, "inv")) {
+            fprintf(file, ", \"error_rms\": ");
+            FFTReportNumber(file, r.error.rms);
+            fprintf(file, ", \"error_max\": ");
+            FFTReportNumber(file, r.error.max);
+        }
+        if (r.hasAllocs) {
+            fprintf(file, ",\n     \"allocs_per_call\": ");
+            FFTReportNumber(file, r.allocsPerCall);
+            if (r.allocBytes >= 0) fprintf(file, ", \"alloc_bytes\": %lld", r.allocBytes);
+            if (r.planBytes >= 0) fprintf(file, ", \"plan_bytes\": %lld", r.planBytes);
+            if (r.peakBytes >= 0) fprintf(file, ", \"peak_bytes\": %lld", r.peakBytes);
+        }
+        if (r.hasStack) fprintf(file, ", \"stack_bytes\": %ld", r.stackBytes);
+        if (r.transforms) fprintf(file, ", \"transforms\": %ld, \"lanes\": %d", r.transforms, r.lanes);
+        if (r.placement) {
+            fprintf(file, ", \"placement\": \"%s\", \"copied\": %s", r.placement, r.copied ? "true" : "false");
+        }
+        if (r.signal) fprintf(file, ", \"signal\": \"%s\", \"ftz\": %s", r.signal, r.flushDenormals ? "true" : "false");
+        if (r.stage) {
+            fprintf(file, ",\n     \"stage\": \"%s\", \"stride\": %ld, \"butterflies\": %ld", r.stage, r.stride,
+                    r.butterflies);
+        }
+        if (r.stage && r.butterflies > 0) {
+            fprintf(file, ", \"ns_per_butterfly\": ");
+            FFTReportNumber(file, r.timing.ns.median / r.butterflies);
+            if (r.timing.cycles.count) {
+                fprintf(file, ", \"cycles_per_butterfly\": ");
+                FFTReportNumber(file, r.timing.cycles.median / r.butterflies);
+            }
+        }
+        if (r.hasHotPath) {
+            fprintf(file, ",\n     \"page_faults\": %ld, \"histogram_ns\": {", r.pageFaults);
+            bool first = true;
+            for (size_t k = 0; k < r.histogram.size(); k++) {
+                if (!r.histogram[k]) continue;
+                fprintf(file, "%s\"%lld\": %ld", first ? "" : ", ", 1LL << k, r.histogram[k]);
+                first = false;
+            }
+            fprintf(file, "}");
+        }
+        if (r.hasCounters) {
+            fprintf(file, ",\n     \"counters\": {");
+            bool first = true;
+            for (int c = 0; c < FFTCounterCount; c++) {
+                double value = r.counters.values[c];
+                if (value < 0) continue;
+                fprintf(file, "%s\"%s\": {\"per_point\": ", first ? "" : ", ", FFTCounterName((FFTCounter)c));
+                FFTReportNumber(file, value / r.length);
+                fprintf(file, ", \"per_butterfly\": ");
+                FFTReportNumber(file, value / FFTBenchButterflies(r.length));
+                fprintf(file, "}");
+                first = false;
+            }
+            fprintf(file, "}");
+        }
+        if (r.hasEnergy) {
+            fprintf(file, ",\n     \"energy\": {");
+            for (int d = 0; d < FFTEnergyDomainCount; d++) {
+                fprintf(file, "%s\"%s_j_per_mpoint\": ", d ? ", " : "", FFTEnergyDomainName((FFTEnergyDomain)d));
+                if (r.energy.joules[d] >= 0) FFTReportNumber(file, r.energy.joules[d] / r.length * 1e6);
+                else fprintf(file, "null");
+            }
+            fprintf(file, "}");
+        }
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+
+/// csv field, quoted when needed
+static std::string FFTReportField(const std::string &s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '"') out += '"';
+        out += s[i];
+    }
+    return out + "\"";
+}
+
+bool FFTReportWriteCSV(const char *path, const FFTMachineInfo &machine, const std::vector<FFTRecord> &records) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "timestamp,processor,arch,os,compiler,flags,build_type,cpus,cache_line_bytes,data_cache_bytes,"
+            "backend,length,precision,transform,layout,direction,threads,premarshal,status,min_ns,median_ns,p90_ns,"
+            "p99_ns,p999_ns,max_ns,mean_ns,ci_low_ns,ci_high_ns,cycles,mpoints_per_s,mfft_per_s,gflops,bytes,error_rms,"
+            "error_max,cache,allocs_per_call,alloc_bytes,plan_bytes,peak_bytes,page_faults,stack_bytes,"
+            "transforms,lanes,placement,copied,signal,ftz,stage,stride,butterflies");
+    for (int c = 0; c < FFTCounterCount; c++) fprintf(file, ",%s_per_point", FFTCounterName((FFTCounter)c));
+    for (int d = 0; d < FFTEnergyDomainCount; d++) {
+        fprintf(file, ",%s_j_per_mpoint", FFTEnergyDomainName((FFTEnergyDomain)d));
+    }
+    fprintf(file, "\n");
+    char sizes[64];
+    snprintf(sizes, sizeof(sizes), "%d,%d,%d", machine.cpus, machine.cacheLineBytes, machine.dataCacheBytes);
+    std::string prefix = FFTReportField(machine.timestamp) + "," + FFTReportField(machine.processor) + "," +
+                         FFTReportField(machine.arch) + "," + FFTReportField(machine.os) + "," +
+                         FFTReportField(machine.compiler) + "," + FFTReportField(machine.flags) + "," +
+                         FFTReportField(machine.buildType) + "," + sizes;
+    for (size_t i = 0; i < records.size(); i++) {
+        const FFTRecord &r = records[i];
+        const FFTStats &ns = r.timing.ns;
+        bool timed = ns.count > 0;
+        bool checked = !strcmp(r.direction, "fwd") || !strcmp(r.direction, "inv");
+        fprintf(file, "%s,%s,%d,%s,%s,%s,%s,%d,%d,%s,", prefix.c_str(), FFTReportField(r.backend).c_str(), r.length,
+                r.precision == FFTPrecisionDouble ? "double" : "float",
+                r.transform == FFTTransformReal ? "real" : "complex",
+                r.inPlace ? "in-place" : "out-of-place", r.direction, r.threads, r.premarshal ? 1 : 0,
+                FFTReportStatusName(r.status));
+        if (timed) {
+            fprintf(file, "%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,", ns.min, ns.median, ns.p90, ns.p99,
+                    ns.p999, ns.max, ns.mean, ns.ciLow, ns.ciHigh);
+        } else {
+            fprintf(file, ",,,,,,,,,");
+        }
+        if (r.timing.cycles.count) fprintf(file, "%.9g", r.timing.cycles.median);
+        fprintf(file, ",");
+        if (timed) fprintf(file, "%.9g", FFTReportMPointsPerSecond(r));
+        fprintf(file, ",");
+        if (r.mfftPerSecond > 0) fprintf(file, "%.9g", r.mfftPerSecond);
+        fprintf(file, ",");
+        if (FFTReportGflops(r) > 0) fprintf(file, "%.9g,%.0f", FFTReportGflops(r), FFTReportBytes(r));
+        else fprintf(file, ",");
+        fprintf(file, ",");
+        if (checked) fprintf(file, "%.9g,%.9g", r.error.rms, r.error.max);
+        else fprintf(file, ",");
+        fprintf(file, ",%s,", r.cache ? r.cache : "");
+        if (r.hasAllocs) fprintf(file, "%.9g", r.allocsPerCall);
+        fprintf(file, ",");
+        if (r.hasAllocs && r.allocBytes >= 0) fprintf(file, "%lld", r.allocBytes);
+        fprintf(file, ",");
+        if (r.hasAllocs && r.planBytes >= 0) fprintf(file, "%lld", r.planBytes);
+        fprintf(file, ",");
+        if (r.hasAllocs && r.peakBytes >= 0) fprintf(file, "%lld", r.peakBytes);
+        fprintf(file, ",");
+        if (r.hasHotPath && r.pageFaults >= 0) fprintf(file, "%ld", r.pageFaults);
+        fprintf(file, ",");
+        if (r.hasStack) fprintf(file, "%ld", r.stackBytes);
+        fprintf(file, ",");
+        if (r.transforms) fprintf(file, "%ld,%d", r.transforms, r.lanes);
+        else fprintf(file, ",");
+        if (r.placement) fprintf(file, ",%s,%d", r.placement, r.copied ? 1 : 0);
+        else fprintf(file, ",,");
+        if (r.signal) fprintf(file, ",%s,%d", r.signal, r.flushDenormals ? 1 : 0);
+        else fprintf(file, ",,");
+        if (r.stage) fprintf(file, ",%s,%ld,%ld", r.stage, r.stride, r.butterflies);
+        else fprintf(file, ",,,");
+        for (int c = 0; c < FFTCounterCount; c++) {
+            fprintf(file, ",");
+            if (r.hasCounters && r.counters.values[c] >= 0) fprintf(file, "%.9g", r.counters.values[c] / r.length);
+        }
+        for (int d = 0; d < FFTEnergyDomainCount; d++) {
+            fprintf(file, ",");
+            if (r.hasEnergy && r.energy.joules[d] >= 0) fprintf(file, "%.9g", r.energy.joules[d] / r.length * 1e6);
+        }
+        fprintf(file, "\n");
+    }
+    return fclose(file) == 0;
+}
+
+
+/// Fields of one csv line as written by FFTReportWriteCSV ("" escapes a quote).
+static std::vector<std::string> FFTReportSplitCSV(const std::string &line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(std::string());
+        } else if (c != '\r' && c != '\n') {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+bool FFTReportReadCSV(const char *path, std::vector<std::string> &header,
+                      std::vector<std::map<std::string, std::string> > &rows) {
+    FILE *file = fopen(path, "r");
+    if (!file) return false;
+
+    std::vector<std::string> lines;
+    std::string line;
+    char chunk[4096];
+    while (fgets(chunk, sizeof(chunk), file)) {
+        line += chunk;
+        if (line[line.size() - 1] != '\n' && !feof(file)) continue;
+        lines.push_back(line);
+        line.clear();
+    }
+    fclose(file);
+    if (lines.empty()) return false;
+
+    header = FFTReportSplitCSV(lines[0]);
+    rows.clear();
+    for (size_t l = 1; l < lines.size(); l++) {
+        std::vector<std::string> f = FFTReportSplitCSV(lines[l]);
+        if (f.size() < header.size()) continue;
+        std::map<std::string, std::string> row;
+        for (size_t i = 0; i < header.size(); i++) row[header[i]] = f[i];
+        rows.push_back(row);
+    }
+    return true;
+}
+
+
+bool FFTReportWrite(const FFTBenchOptions &options, const std::vector<FFTRecord> &records) {
+    if (options.jsonPath.empty() && options.csvPath.empty()) return true;
+    FFTMachineInfo machine = FFTMachineInfoGet();
+    bool ok = true;
+    if (!options.jsonPath.empty() && !FFTReportWriteJSON(options.jsonPath.c_str(), options, machine, records)) {
+        fprintf(stderr, "cannot write %s\n", options.jsonPath.c_str());
+        ok = false;
+    }
+    if (!options.csvPath.empty() && !FFTReportWriteCSV(options.csvPath.c_str(), machine, records)) {
+        fprintf(stderr, "cannot write %s\n", options.csvPath.c_str());
+        ok = false;
+    }
+    return ok;
+}
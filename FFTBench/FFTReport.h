@@ -0,0 +1,98 @@
+//
+//  FFTReport.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTReport__
+#define __FFTBench__FFTReport__
+
+#include "FFTBench.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+ Machine-readable results, written next to the printf output with --json/--csv.
+
+    json:  {"machine": {...}, "options": {...}, "records": [{...}, ...]}
+    csv:   one row per record, the machine columns repeated on every row
+
+ One record per (backend, length, precision, transform, layout, direction,
+ threads). Result/plot.py turns a json file into the Result/ charts.
+ */
+
+/// Where the numbers come from.
+struct FFTMachineInfo {
+    std::string processor;     ///< SIMDBase_getProcessorNameString()
+    std::string arch;          ///< x86_64, arm64, ...
+    std::string os;            ///< uname sysname and release
+    std::string compiler;
+    std::string flags;         ///< compiler flags of the build type
+    std::string buildType;
+    std::string timestamp;     ///< UTC, ISO 8601
+    int cpus;
+    int cacheLineBytes;        ///< SIMDBase_sizeOfCachelineInByte()
+    int dataCacheBytes;        ///< SIMDBase_sizeOfDataCacheInByte(), L2 + L3 on x86
+};
+
+FFTMachineInfo FFTMachineInfoGet(void);
+
+
+struct FFTRecord {
+    std::string backend;
+    int length;
+    FFTPrecision precision;
+    FFTTransform transform;
+    bool inPlace;
+    const char *direction;     ///< load, fwd, inv, store, or roundtrip for throughput
+    const char *cache;         ///< hot, cold or flushed for the cold cache mode, NULL otherwise
+    int threads;
+    bool premarshal;           ///< input marshalled before the timed loop, not reloaded by every iteration
+    FFTBenchStatus status;
+    FFTTiming timing;          ///< per transform, timing.ns.count == 0 for throughput records
+    double mfftPerSecond;      ///< throughput records, 0 otherwise
+    FFTError error;            ///< fwd/inv records, 0 otherwise
+    bool hasCounters;
+    FFTCounterSample counters; ///< fwd/inv records with --counters, per transform
+    bool hasEnergy;
+    FFTEnergySample energy;    ///< fwd/inv records with --energy, per transform
+    bool hasAllocs;            ///< heap counted by FFTAlloc
+    double allocsPerCall;      ///< heap allocations per call
+    long long allocBytes;      ///< heap a setup keeps (setup, fwd/inv), teardown leaks (teardown), -1: not known
+    long long planBytes;       ///< of allocBytes, kept by the library's plan constructors, -1: not known
+    long long peakBytes;       ///< transient heap peak of one call (fwd/inv), -1: not known
+    bool hasStack;
+    long stackBytes;           ///< stack of one call
+    bool hasHotPath;           ///< latency records
+    long pageFaults;           ///< of the timed loop, -1 if unknown
+    std::vector<long> histogram; ///< latency records, bucket k counts [2^k, 2^(k+1)) ns
+    long transforms;           ///< batch records: independent transforms per pass, 0 otherwise
+    int lanes;                 ///< batch records: transforms per call (SIMD lanes), 1 for the per-call path
+    const char *placement;     ///< alignment records: own, +<offset> or +<offset>/4k, NULL otherwise
+    bool copied;               ///< alignment records: input copied into the library's own buffers
+    const char *signal;        ///< input class (FFTSignalName) if not the default cosines, NULL otherwise
+    bool flushDenormals;       ///< timed with FTZ/DAZ on
+    const char *stage;         ///< kernel records (direction is the kernel): first, last, leaf or all,
+                               ///< stage records (direction is the region): its level, NULL otherwise
+    long stride;               ///< kernel records: stride the kernel is called with, stage records: regions per call
+    long butterflies;          ///< kernel records: butterflies per timed pass, 0 for stage records
+};
+
+/// Append the phase records of each sweep result, fwd+load and inv+load when they were timed.
+void FFTReportAddResults(const std::vector<FFTBenchResult> &results, std::vector<FFTRecord> &records);
+
+/// Write `records` as csv, false on I/O error.
+bool FFTReportWriteCSV(const char *path, const FFTMachineInfo &machine, const std::vector<FFTRecord> &records);
+
+/// Column names and rows (column -> field) of a csv written by FFTReportWriteCSV, false if it cannot be
+/// read; rows shorter than the header are dropped.
+bool FFTReportReadCSV(const char *path, std::vector<std::string> &header,
+                      std::vector<std::map<std::string, std::string> > &rows);
+
+/// Write options.jsonPath and options.csvPath (when set), false on I/O error.
+bool FFTReportWrite(const FFTBenchOptions &options, const std::vector<FFTRecord> &records);
+
+#endif /* defined(__FFTBench__FFTReport__) */
@@ -0,0 +1,257 @@
+//
+//  FFTRoofline.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTRoofline.h"
+#include "FFTTimer.h"
+#include "SIMDBase.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#define FFTRooflineTrials 5
+#define FFTRooflineTrialNanoseconds 20000000    // 20 ms per trial
+#define FFTRooflineL1Bytes 32768                // level boundary; the l1 triad runs on half of it
+#define FFTRooflineCacheMaxBytes (4 << 20)      // server L3 sizes are shared, a core sees a slice
+#define FFTRooflineDRAMMinBytes (64 << 20)
+#define FFTRooflineDRAMMaxBytes (256 << 20)
+#define FFTRooflineCacheDefault (4 << 20)       // when SIMDBase cannot tell the data cache size
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FFTROOFLINE_X86 1
+#endif
+
+
+double FFTRooflineFlops(int length, FFTTransform transform) {
+    double flops = 5.0 * length * log2((double)length);
+    return transform == FFTTransformReal ? flops / 2 : flops;
+}
+
+double FFTRooflineBytes(int length, FFTTransform transform, FFTPrecision precision) {
+    double scalar = precision == FFTPrecisionDouble ? sizeof(double) : sizeof(float);
+    return (transform == FFTTransformReal ? 2.0 : 4.0) * length * scalar;
+}
+
+
+#if defined(__GNUC__)
+
+typedef float FFTRooflineFloat4 __attribute__((vector_size(16)));
+typedef double FFTRooflineDouble2 __attribute__((vector_size(16)));
+#if FFTROOFLINE_X86
+typedef float FFTRooflineFloat8 __attribute__((vector_size(32)));
+typedef double FFTRooflineDouble4 __attribute__((vector_size(32)));
+typedef float FFTRooflineFloat16 __attribute__((vector_size(64)));
+typedef double FFTRooflineDouble8 __attribute__((vector_size(64)));
+#endif
+
+/// 12 independent a = a * m + c chains of `iterations` steps, 2 flops per lane and step; the
+/// chains converge to c / (1 - m), far from overflow and subnormals.
+template <typename V, typename S>
+static inline __attribute__((always_inline)) double FFTRooflineChains(long iterations) {
+    V m, c;
+    for (size_t k = 0; k < sizeof(V) / sizeof(S); k++) {
+        m[k] = (S)0.9999;
+        c[k] = (S)0.001;
+    }
+    V a0 = c, a1 = c * 2, a2 = c * 3, a3 = c * 4, a4 = c * 5, a5 = c * 6;
+    V a6 = c * 7, a7 = c * 8, a8 = c * 9, a9 = c * 10, a10 = c * 11, a11 = c * 12;
+    for (long i = 0; i < iterations; i++) {
+        a0 = a0 * m + c; a1 = a1 * m + c; a2 = a2 * m + c; a3 = a3 * m + c;
+        a4 = a4 * m + c; a5 = a5 * m + c; a6 = a6 * m + c; a7 = a7 * m + c;
+        a8 = a8 * m + c; a9 = a9 * m + c; a10 = a10 * m + c; a11 = a11 * m + c;
+    }
+    V sum = a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11;
+    double total = 0;
+    for (size_t k = 0; k < sizeof(V) / sizeof(S); k++) total += sum[k];
+    return total;
+}
+
+/// c[i] = a[i] + s * b[i] over `bytes` of each array, `repeats` times.
+template <typename V>
+static inline __attribute__((always_inline)) void FFTRooflineTriad(const void *a, const void *b, void *c,
+                                                                  size_t bytes, long repeats) {
+    const V *va = (const V *)a, *vb = (const V *)b;
+    V *vc = (V *)c;
+    size_t count = bytes / sizeof(V);
+    for (long r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < count; i++) vc[i] = va[i] + vb[i] * (float)1.0001;
+        __asm__ __volatile__("" : : "r"(vc) : "memory"); // keep every pass
+    }
+}
+
+#define FFTROOFLINE_KERNELS(name, target, Float, Double)                                                       \
+    target static double FFTRooflineChains_##name(long iterations, bool isDouble) {                            \
+        return isDouble ? FFTRooflineChains<Double, double>(iterations)                                        \
+                        : FFTRooflineChains<Float, float>(iterations);                                         \
+    }                                                                                                          \
+    target static void FFTRooflineTriad_##name(const void *a, const void *b, void *c, size_t bytes,            \
+                                               long repeats) {                                                 \
+        FFTRooflineTriad<Float>(a, b, c, bytes, repeats);                                                      \
+    }
+
+FFTROOFLINE_KERNELS(base, , FFTRooflineFloat4, FFTRooflineDouble2)
+#if FFTROOFLINE_X86
+FFTROOFLINE_KERNELS(avx, __attribute__((target("avx"))), FFTRooflineFloat8, FFTRooflineDouble4)
+FFTROOFLINE_KERNELS(avx2, __attribute__((target("avx2,fma"))), FFTRooflineFloat8, FFTRooflineDouble4)
+FFTROOFLINE_KERNELS(avx512, __attribute__((target("avx512f"))), FFTRooflineFloat16, FFTRooflineDouble8)
+#endif
+
+#else
+
+static double FFTRooflineChains_base(long iterations, bool isDouble) {
+    double a[12], total = 0;
+    for (int j = 0; j < 12; j++) a[j] = 0.001 * (j + 1);
+    for (long i = 0; i < iterations; i++) {
+        for (int j = 0; j < 12; j++) a[j] = a[j] * 0.9999 + 0.001;
+    }
+    for (int j = 0; j < 12; j++) total += a[j];
+    return total;
+}
+
+static void FFTRooflineTriad_base(const void *a, const void *b, void *c, size_t bytes, long repeats) {
+    const float *fa = (const float *)a, *fb = (const float *)b;
+    volatile float *fc = (volatile float *)c;
+    for (long r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < bytes / sizeof(float); i++) fc[i] = fa[i] + fb[i] * 1.0001f;
+    }
+}
+
+#endif
+
+
+/// One vector extension: its kernels, lanes of 4-byte floats, and whether this cpu runs it.
+struct FFTRooflineISA {
+    const char *name;
+    double (*chains)(long iterations, bool isDouble);
+    void (*triad)(const void *a, const void *b, void *c, size_t bytes, long repeats);
+    int floatLanes;
+    bool available;
+};
+
+static std::vector<FFTRooflineISA> FFTRooflineISAs(void) {
+    std::vector<FFTRooflineISA> isas;
+#if FFTROOFLINE_X86
+    FFTRooflineISA base = {"sse2", FFTRooflineChains_base, FFTRooflineTriad_base, 4, true};
+    FFTRooflineISA avx = {"avx", FFTRooflineChains_avx, FFTRooflineTriad_avx, 8,
+                          (bool)__builtin_cpu_supports("avx")};
+    FFTRooflineISA avx2 = {"avx2+fma", FFTRooflineChains_avx2, FFTRooflineTriad_avx2, 8,
+                           __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")};
+    FFTRooflineISA avx512 = {"avx512f", FFTRooflineChains_avx512, FFTRooflineTriad_avx512, 16,
+                             (bool)__builtin_cpu_supports("avx512f")};
+    isas.push_back(base);
+    isas.push_back(avx);
+    isas.push_back(avx2);
+    isas.push_back(avx512);
+#elif defined(__GNUC__)
+    FFTRooflineISA base = {"simd", FFTRooflineChains_base, FFTRooflineTriad_base, 4, true};
+    isas.push_back(base);
+#else
+    FFTRooflineISA base = {"scalar", FFTRooflineChains_base, FFTRooflineTriad_base, 1, true};
+    isas.push_back(base);
+#endif
+    return isas;
+}
+
+
+static volatile double FFTRooflineSink;
+
+/// Fastest of FFTRooflineTrials runs of `block(repeats)` in ns, repeats grown until a run
+/// takes FFTRooflineTrialNanoseconds.
+template <typename Block>
+static double FFTRooflineBest(long &repeats, Block block) {
+    repeats = 1;
+    for (;;) {
+        uint64_t t0 = FFTTimerNanoseconds();
+        block(repeats);
+        uint64_t t1 = FFTTimerNanoseconds();
+        if (t1 - t0 >= FFTRooflineTrialNanoseconds || repeats >= (1L << 30)) break;
+        repeats *= 2;
+    }
+    double best = 0;
+    for (int t = 0; t < FFTRooflineTrials; t++) {
+        uint64_t t0 = FFTTimerNanoseconds();
+        block(repeats);
+        uint64_t t1 = FFTTimerNanoseconds();
+        if (t == 0 || t1 - t0 < best) best = (double)(t1 - t0);
+    }
+    return best;
+}
+
+/// Triad GB/s on three arrays of `bytes` / 3.
+static double FFTRooflineBandwidth(const FFTRooflineISA &isa, size_t bytes) {
+    size_t each = std::max(bytes / 3 / 64 * 64, (size_t)64);
+    char *a = (char *)SIMDBase_alignedMalloc(each);
+    char *b = (char *)SIMDBase_alignedMalloc(each);
+    char *c = (char *)SIMDBase_alignedMalloc(each);
+    memset(a, 0, each);
+    memset(b, 0, each);
+    memset(c, 0, each);
+    long repeats;
+    double ns = FFTRooflineBest(repeats, [&](long n) { isa.triad(a, b, c, each, n); });
+    SIMDBase_alignedFree(a);
+    SIMDBase_alignedFree(b);
+    SIMDBase_alignedFree(c);
+    return 3.0 * each * repeats / ns;
+}
+
+
+const FFTRoofline &FFTRooflineMeasure(FFTPrecision precision) {
+    static FFTRoofline measured[2];
+    static bool done[2];
+    int index = precision == FFTPrecisionDouble ? 1 : 0;
+    if (done[index]) return measured[index];
+
+    FFTRoofline &roofline = measured[index];
+    std::vector<FFTRooflineISA> isas = FFTRooflineISAs();
+    const FFTRooflineISA *widest = &isas[0];
+    bool isDouble = precision == FFTPrecisionDouble;
+    for (size_t i = 0; i < isas.size(); i++) {
+        if (!isas[i].available) continue;
+        long repeats;
+        double ns = FFTRooflineBest(repeats, [&](long n) { FFTRooflineSink = isas[i].chains(n * 1024, isDouble); });
+        double lanes = isDouble ? isas[i].floatLanes / 2.0 : isas[i].floatLanes;
+        double gflops = 2.0 * 12 * lanes * repeats * 1024 / ns;
+        if (gflops > roofline.gflops) {
+            roofline.gflops = gflops;
+            roofline.isa = isas[i].name;
+        }
+        widest = &isas[i];
+    }
+
+    const FFTRoofline &other = measured[1 - index];
+    if (done[1 - index]) {
+        roofline.l1 = other.l1;
+        roofline.cache = other.cache;
+        roofline.dram = other.dram;
+        roofline.cacheBytes = other.cacheBytes;
+    } else {
+        long long cache = SIMDBase_sizeOfDataCacheInByte();
+        if (cache <= 0) cache = FFTRooflineCacheDefault;
+        roofline.cacheBytes = cache;
+        roofline.l1 = FFTRooflineBandwidth(*widest, FFTRooflineL1Bytes / 2);
+        roofline.cache = FFTRooflineBandwidth(*widest, (size_t)std::min(cache / 2, (long long)FFTRooflineCacheMaxBytes));
+        long long dram = std::min(std::max(cache * 4, (long long)FFTRooflineDRAMMinBytes),
+                                  (long long)FFTRooflineDRAMMaxBytes);
+        roofline.dram = FFTRooflineBandwidth(*widest, (size_t)dram);
+    }
+    done[index] = true;
+    return roofline;
+}
+
+
+const char *FFTRooflineLevel(const FFTRoofline &roofline, double bytes) {
+    if (bytes <= FFTRooflineL1Bytes) return "l1";
+    if (bytes <= roofline.cacheBytes) return "cache";
+    return "dram";
+}
+
+double FFTRooflineBound(const FFTRoofline &roofline, int length, FFTTransform transform, FFTPrecision precision) {
+    double bytes = FFTRooflineBytes(length, transform, precision);
+    const char *level = FFTRooflineLevel(roofline, bytes);
+    double bandwidth = !strcmp(level, "l1") ? roofline.l1 : !strcmp(level, "cache") ? roofline.cache : roofline.dram;
+    return std::min(roofline.gflops, FFTRooflineFlops(length, transform) / bytes * bandwidth);
+}
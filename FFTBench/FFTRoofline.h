@@ -0,0 +1,67 @@
+//
+//  FFTRoofline.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTRoofline__
+#define __FFTBench__FFTRoofline__
+
+#include "FFTBackend.h"
+
+/*
+ Work and traffic of a transform, and the limits of the machine.
+
+ Points per second are not comparable across lengths, the work of an FFT
+ grows as N log2 N. The nominal flop count (as used by benchFFT) is
+
+    complex   5 N log2 N
+    real      2.5 N log2 N
+
+ for every algorithm and length, so GFLOPS = nominal flops / ns is a speed
+ scaled by the work, not a count of executed instructions. The nominal
+ traffic is reading the input and writing the output once (4 N scalars for a
+ complex transform, 2 N for a real one); flops / bytes is the arithmetic
+ intensity of the point on a roofline chart.
+
+ The roofs are measured with built-in micro-kernels:
+
+    peak     12 independent multiply-add chains on the widest vectors the cpu
+             runs (sse2, avx, avx2+fma, avx512f on x86; the compiler's
+             default elsewhere), the attainable rate of compiled code
+    l1       a[i] + s * b[i] -> c[i] (STREAM triad) on 16 KB
+    cache    the same on half the data cache (L2 + L3), at most 4 MB
+    dram     the same on 4 times the data cache, 64 to 256 MB
+
+ A point is bound by min(peak, intensity x bandwidth) of the level its
+ nominal traffic fits in.
+ */
+
+/// Nominal flops of one transform.
+double FFTRooflineFlops(int length, FFTTransform transform);
+
+/// Nominal bytes of one transform: input read and output written once.
+double FFTRooflineBytes(int length, FFTTransform transform, FFTPrecision precision);
+
+
+/// Measured limits of the machine; bandwidths in GB/s.
+struct FFTRoofline {
+    double gflops;             ///< peak of the multiply-add kernel in this precision
+    const char *isa;           ///< the vector extension that reached it
+    double l1;
+    double cache;
+    double dram;
+    long long cacheBytes;      ///< working sets up to this size use the cache roof
+};
+
+/// Measure the roofs (about a second, once per precision; later calls return the same).
+const FFTRoofline &FFTRooflineMeasure(FFTPrecision precision);
+
+/// "l1", "cache" or "dram": the level `bytes` of traffic fits in.
+const char *FFTRooflineLevel(const FFTRoofline &roofline, double bytes);
+
+/// Attainable GFLOPS of a transform: min(peak, intensity x bandwidth of its level).
+double FFTRooflineBound(const FFTRoofline &roofline, int length, FFTTransform transform, FFTPrecision precision);
+
+#endif /* defined(__FFTBench__FFTRoofline__) */
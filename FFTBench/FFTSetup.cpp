@@ -0,0 +1,156 @@
+//
+//  FFTSetup.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTSetup.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+#include "FFTAlloc.h"
+
+#include <stdio.h>
+
+#define FFTSetupMinRepeats 3
+
+
+/// Timings and heap use of repeated setup/teardown pairs, false if a setup failed.
+struct FFTSetupCost {
+    double first;              ///< ns of the first plan
+    std::vector<double> plan;  ///< ns of the library's plan constructors (FFTPlanScope)
+    std::vector<double> setup; ///< ns of the whole setup(), the backend's buffers included
+    std::vector<double> teardown;
+    long planAllocs;           ///< heap allocations of one plan
+    long long planBytes;       ///< heap bytes one plan leaves allocated
+    long allocs;               ///< heap allocations of one setup
+    long long bytes;           ///< heap bytes one setup leaves allocated
+    long long leaked;          ///< of those, bytes teardown did not free
+};
+
+static bool FFTSetupMeasure(const FFTBackendInfo *info, int length, const FFTBenchOptions &options,
+                            FFTSetupCost &cost) {
+    int trials = options.timer.trials > FFTSetupMinRepeats ? options.timer.trials : FFTSetupMinRepeats;
+    uint64_t budget = (uint64_t)(options.seconds * 1e9);
+    uint64_t start = FFTTimerNanoseconds();
+    cost.first = 0;
+    cost.planAllocs = cost.allocs = 0;
+    cost.planBytes = cost.bytes = cost.leaked = 0;
+
+    for (int t = 0; t < trials; t++) {
+        FFTBackend *backend = info->create();
+        FFTPlanReset();
+        FFTAllocTrack(true);
+        FFTAllocCount a0 = FFTAllocRead();
+        uint64_t t0 = FFTTimerNanoseconds();
+        bool ok = backend->setup(length);
+        uint64_t t1 = FFTTimerNanoseconds();
+        FFTAllocCount a1 = FFTAllocRead();
+        FFTPlanCost plan = FFTPlanRead();
+        backend->teardown();
+        uint64_t t2 = FFTTimerNanoseconds();
+        FFTAllocCount a2 = FFTAllocRead();
+        FFTAllocTrack(false);
+        delete backend;
+        if (!ok) return false;
+
+        if (t == 0) cost.first = plan.ns;
+        cost.plan.push_back(plan.ns);
+        cost.setup.push_back((double)(t1 - t0));
+        cost.teardown.push_back((double)(t2 - t1));
+        cost.planAllocs = plan.allocs;
+        cost.planBytes = plan.bytes;
+        cost.allocs = a1.calls - a0.calls;
+        cost.bytes = a1.live - a0.live;
+        cost.leaked = a2.live - a0.live;
+        if (t + 1 >= FFTSetupMinRepeats && FFTTimerNanoseconds() - start > budget) break;
+    }
+    return true;
+}
+
+
+static FFTRecord FFTSetupRecord(const FFTBackendInfo *info, int length, const char *direction,
+                                const std::vector<double> &samples) {
+    FFTRecord record = FFTRecord();
+    record.backend = info->name;
+    record.length = length;
+    record.precision = info->precision;
+    record.transform = info->transform;
+    record.direction = direction;
+    record.threads = 1;
+    record.status = FFTBenchStatusOK;
+    record.timing.batch = 1;
+    record.timing.ns = FFTStatsCompute(samples);
+    record.hasAllocs = FFTAllocAvailable();
+    record.peakBytes = -1;
+    return record;
+}
+
+
+int FFTSetupRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    FFTBenchPrintEnvironment();
+    printf("setup: up to %d setup/teardown pairs or %.2f s per cell, plan: the library's constructors alone%s\n",
+           options.timer.trials, options.seconds,
+           FFTAllocAvailable() ? "" : ", heap not counted in this build");
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        int length = lengths[l];
+        printf("%d-------\n", length);
+
+        for (size_t b = 0; b < backends.size(); b++) {
+            const FFTBackendInfo *info = backends[b];
+            std::string label = std::string(info->name) + ":";
+            FFTBackend *probe = info->create();
+            bool supported = probe->supports(length);
+            delete probe;
+            if (!supported) continue;
+
+            FFTSetupCost cost;
+            if (!FFTSetupMeasure(info, length, options, cost)) {
+                printf("%-6s setup failed\n", label.c_str());
+                FFTRecord record = FFTSetupRecord(info, length, "plan", std::vector<double>());
+                record.status = FFTBenchStatusSetupFailed;
+                record.hasAllocs = false;
+                records.push_back(record);
+                failures++;
+                continue;
+            }
+
+            FFTRecord plan = FFTSetupRecord(info, length, "plan", cost.plan);
+            plan.allocsPerCall = (double)cost.planAllocs;
+            plan.allocBytes = plan.planBytes = cost.planBytes;
+            FFTRecord setup = FFTSetupRecord(info, length, "setup", cost.setup);
+            setup.allocsPerCall = (double)cost.allocs;
+            setup.allocBytes = cost.bytes;
+            setup.planBytes = cost.planBytes;
+            FFTRecord teardown = FFTSetupRecord(info, length, "teardown", cost.teardown);
+            teardown.allocsPerCall = 0;
+            teardown.allocBytes = cost.leaked;
+            teardown.planBytes = -1;
+            records.push_back(plan);
+            records.push_back(setup);
+            records.push_back(teardown);
+
+            printf("%-6s plan   first %10.1f  med %10.1f  max %10.1f us  setup med %10.1f  teardown med %8.1f us",
+                   label.c_str(), cost.first * 1e-3, plan.timing.ns.median * 1e-3, plan.timing.ns.max * 1e-3,
+                   setup.timing.ns.median * 1e-3, teardown.timing.ns.median * 1e-3);
+            if (FFTAllocAvailable()) {
+                printf("  allocs %ld  plan %.1f KB  buffers %.1f KB", cost.planAllocs, cost.planBytes / 1024.0,
+                       (cost.bytes - cost.planBytes) / 1024.0);
+                if (cost.leaked > 0) printf("  ! leaks %lld B", cost.leaked);
+            }
+            printf("\n");
+        }
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
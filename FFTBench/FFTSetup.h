@@ -0,0 +1,36 @@
+//
+//  FFTSetup.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTSetup__
+#define __FFTBench__FFTSetup__
+
+#include "FFTBench.h"
+
+/*
+ Plan construction cost, which the sweep keeps out of its timed region:
+
+    for() {
+      t0; backend->setup(length); t1; backend->teardown(); t2;
+    }
+
+ setup() is everything a backend needs before its first transform: the plan
+ (kiss_fft_alloc, pffft_new_setup, CkFftInit, DFT_init with its test runs,
+ ne10_fft_alloc_c2c_float32, fftwf_plan_dft_1d) and the backend's buffers.
+ The plan figures (time, heap calls and bytes) cover the library's
+ constructors alone, from the FFTPlanScope the backends put around them, so
+ the malloc and memset of the buffers do not hide a cheap plan; the whole
+ setup() time is printed next to them. Each cell runs options.timer.trials
+ setups or stops after options.seconds, and reports the first plan on its own
+ since it may pay one-time library initialization. Heap comes from FFTAlloc.
+ Planner levels are backends of their own: fftw-measure (FFTW_MEASURE) and
+ nsfft-light/-heavy/-exh (DFT_FLAG_*_TEST_RUN).
+ */
+
+/// Run the setup benchmark over the lengths of options, return the number of failures.
+int FFTSetupRun(const FFTBenchOptions &options);
+
+#endif /* defined(__FFTBench__FFTSetup__) */
@@ -0,0 +1,146 @@
+//
+//  FFTSignal.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTSignal.h"
+#include "FFTBench.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define FFTSIGNAL_HAS_MXCSR 1
+#define FFTSignalMXCSRFlush 0x8040 // FTZ (bit 15) | DAZ (bit 6)
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__VFP_FP__) && !defined(__SOFTFP__))
+#define FFTSIGNAL_HAS_ARM_FZ 1
+#define FFTSignalARMFlush (1u << 24) // FZ of FPCR (arm64) / FPSCR (armv7)
+#endif
+
+
+const char *FFTSignalName(FFTSignal signal) {
+    switch (signal) {
+        case FFTSignalCosines: return "cosines";
+        case FFTSignalNoise: return "noise";
+        case FFTSignalImpulse: return "impulse";
+        case FFTSignalDecay: return "decay";
+        case FFTSignalTone: return "tone";
+        case FFTSignalSparse: return "sparse";
+        default: return "";
+    }
+}
+
+bool FFTSignalParse(const char *name, FFTSignal *signal) {
+    for (int s = 0; s < FFTSignalCount; s++) {
+        if (strcmp(name, FFTSignalName((FFTSignal)s))) continue;
+        *signal = (FFTSignal)s;
+        return true;
+    }
+    return false;
+}
+
+
+/// Uniform in [-1, 1), fixed sequence (32-bit LCG of Numerical Recipes).
+static double FFTSignalNoiseNext(uint32_t *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (double)*state / 2147483648.0 - 1;
+}
+
+void FFTSignalGenerate(FFTSignal signal, FFTTransform transform, FFTPrecision precision,
+                       double *real, double *imag, int length) {
+    memset(real, 0, length * sizeof(double));
+    memset(imag, 0, length * sizeof(double));
+    uint32_t state = 12345;
+
+    switch (signal) {
+        case FFTSignalCosines:
+            FFTBenchGenerateInput(real, imag, length);
+            break;
+
+        case FFTSignalNoise:
+            for (int i = 0; i < length; i++) {
+                real[i] = FFTSignalNoiseNext(&state);
+                imag[i] = FFTSignalNoiseNext(&state);
+            }
+            break;
+
+        case FFTSignalImpulse:
+            real[0] = 1;
+            break;
+
+        case FFTSignalDecay: {
+            // log2 of the envelope falls linearly from 2^20 * min normal to the smallest subnormal
+            bool isDouble = precision == FFTPrecisionDouble;
+            double top = log2(isDouble ? DBL_MIN : FLT_MIN) + 20;
+            double bottom = isDouble ? -1074 : -149;
+            for (int i = 0; i < length; i++) {
+                double envelope = exp2(top + (bottom - top) * i / (length > 1 ? length - 1 : 1));
+                real[i] = FFTSignalNoiseNext(&state) * envelope;
+                imag[i] = FFTSignalNoiseNext(&state) * envelope;
+            }
+            break;
+        }
+
+        case FFTSignalTone: {
+            double bin = length * 0.1 + 0.5; // halfway between two bins
+            for (int i = 0; i < length; i++) {
+                double phase = 2 * M_PI * bin * i / length;
+                real[i] = cos(phase);
+                imag[i] = sin(phase);
+            }
+            break;
+        }
+
+        case FFTSignalSparse: {
+            int bins[4] = {1, length / 7, length / 3, length / 2 - 1};
+            for (int b = 0; b < 4; b++) {
+                for (int i = 0; i < length; i++) {
+                    double phase = 2 * M_PI * (double)bins[b] * i / length;
+                    real[i] += cos(phase);
+                    imag[i] += sin(phase);
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+    if (transform == FFTTransformReal) memset(imag, 0, length * sizeof(double));
+}
+
+
+bool FFTSignalCanFlushDenormals(void) {
+#if FFTSIGNAL_HAS_MXCSR || FFTSIGNAL_HAS_ARM_FZ
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FFTSignalSetFlushDenormals(bool flush) {
+#if FFTSIGNAL_HAS_MXCSR
+    unsigned int csr = _mm_getcsr();
+    _mm_setcsr(flush ? (csr | FFTSignalMXCSRFlush) : (csr & ~FFTSignalMXCSRFlush));
+    return (csr & FFTSignalMXCSRFlush) != 0;
+#elif FFTSIGNAL_HAS_ARM_FZ && defined(__aarch64__)
+    uint64_t fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    uint64_t next = flush ? (fpcr | FFTSignalARMFlush) : (fpcr & ~(uint64_t)FFTSignalARMFlush);
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(next));
+    return (fpcr & FFTSignalARMFlush) != 0;
+#elif FFTSIGNAL_HAS_ARM_FZ
+    uint32_t fpscr;
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+    uint32_t next = flush ? (fpscr | FFTSignalARMFlush) : (fpscr & ~FFTSignalARMFlush);
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"(next));
+    return (fpscr & FFTSignalARMFlush) != 0;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,60 @@
+//
+//  FFTSignal.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTSignal__
+#define __FFTBench__FFTSignal__
+
+#include "FFTBackend.h"
+
+/*
+ Input conditions: what the transforms are fed, and how the FPU treats
+ subnormal numbers while they run.
+
+    cosines  the four-tone audio mix of the original FFTRun (default)
+    noise    uniform white noise in [-1, 1), real and imaginary parts
+    impulse  x[0] = 1, a flat spectrum from a signal of zeros
+    decay    noise fading from 2^20 times the smallest normal number of the
+             precision down to its smallest subnormal: near-silence, where
+             scalar butterflies (kf_bfly4, fftradixf) hit microcode assists
+    tone     one full-scale complex exponential (a cosine for real
+             transforms) between two bins, leaking into all of them
+    sparse   four unit bins, exactly on the bin grid
+
+ FTZ/DAZ (x86 MXCSR flush-to-zero and denormals-are-zero, the FZ bit of the
+ ARM FPSCR/FPCR) only applies to the calling thread; the long double
+ reference runs on the x87 unit and is not affected.
+ */
+
+typedef enum {
+    FFTSignalCosines,
+    FFTSignalNoise,
+    FFTSignalImpulse,
+    FFTSignalDecay,
+    FFTSignalTone,
+    FFTSignalSparse,
+    FFTSignalCount,
+} FFTSignal;
+
+/// Short name, as used on the command line and in the reports.
+const char *FFTSignalName(FFTSignal signal);
+
+/// Parse a name of FFTSignalName, false if unknown.
+bool FFTSignalParse(const char *name, FFTSignal *signal);
+
+/// `length` samples of `signal`, scaled for `precision` (decay), with zero imaginary parts for
+/// the real track; the same for every call.
+void FFTSignalGenerate(FFTSignal signal, FFTTransform transform, FFTPrecision precision,
+                       double *real, double *imag, int length);
+
+
+/// Whether this cpu/build can switch subnormal flushing.
+bool FFTSignalCanFlushDenormals(void);
+
+/// Switch FTZ/DAZ of the calling thread, return the previous state.
+bool FFTSignalSetFlushDenormals(bool flush);
+
+#endif /* defined(__FFTBench__FFTSignal__) */
@@ -0,0 +1,73 @@
+//
+//  FFTSizes.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTSizes.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+
+bool FFTSizeSetParse(const char *name, FFTSizeSet *set) {
+    if (!strcmp(name, "pow2")) *set = FFTSizeSetPow2;
+    else if (!strcmp(name, "235")) *set = FFTSizeSetSmooth235;
+    else if (!strcmp(name, "7smooth")) *set = FFTSizeSetSmooth7;
+    else if (!strcmp(name, "prime")) *set = FFTSizeSetPrime;
+    else return false;
+    return true;
+}
+
+bool FFTSizeIsSmooth235(int length) {
+    if (length <= 0) return false;
+    while (length % 2 == 0) length /= 2;
+    while (length % 3 == 0) length /= 3;
+    while (length % 5 == 0) length /= 5;
+    return length == 1;
+}
+
+static bool FFTSizeIsPrime(int n) {
+    if (n < 2) return false;
+    for (int d = 2; (long)d * d <= n; d++) {
+        if (n % d == 0) return false;
+    }
+    return true;
+}
+
+std::vector<int> FFTSizesGenerate(FFTSizeSet set, int minLength, int maxLength) {
+    std::vector<int> sizes;
+    switch (set) {
+        case FFTSizeSetPow2: {
+            for (long n = 1; n <= maxLength; n *= 2) {
+                if (n >= minLength) sizes.push_back((int)n);
+            }
+        } break;
+
+        case FFTSizeSetSmooth235:
+        case FFTSizeSetSmooth7: {
+            bool seven = (set == FFTSizeSetSmooth7);
+            for (long a = 1; a <= maxLength; a *= 2)
+            for (long b = a; b <= maxLength; b *= 3)
+            for (long c = b; c <= maxLength; c *= 5)
+            for (long d = c; d <= maxLength; d *= 7) {
+                if (d >= minLength && (d != c) == seven) sizes.push_back((int)d);
+                if (!seven) break;
+            }
+        } break;
+
+        case FFTSizeSetPrime: {
+            for (int k = 2; ; k++) {
+                int n = (int)lround(pow(2.0, k / 2.0));
+                if (n > maxLength) break;
+                while (n > 2 && !FFTSizeIsPrime(n)) n--;
+                if (n >= minLength && (sizes.empty() || sizes.back() != n)) sizes.push_back(n);
+            }
+        } break;
+    }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    return sizes;
+}
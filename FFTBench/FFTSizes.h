@@ -0,0 +1,33 @@
+//
+//  FFTSizes.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTSizes__
+#define __FFTBench__FFTSizes__
+
+#include <vector>
+
+typedef enum {
+    FFTSizeSetPow2,       ///< 2^a, the original sweep
+    FFTSizeSetSmooth235,  ///< 2^a * 3^b * 5^c (480, 960, 1536 ...)
+    FFTSizeSetSmooth7,    ///< 2^a * 3^b * 5^c * 7^d with d > 0
+    FFTSizeSetPrime,      ///< largest prime below each half octave 2^(k/2)
+} FFTSizeSet;
+
+/// Parse "pow2", "235", "7smooth" or "prime", false if unknown.
+bool FFTSizeSetParse(const char *name, FFTSizeSet *set);
+
+/// Sorted lengths of `set` in [minLength, maxLength].
+std::vector<int> FFTSizesGenerate(FFTSizeSet set, int minLength, int maxLength);
+
+/// Whether length has no prime factor other than 2, 3 and 5.
+bool FFTSizeIsSmooth235(int length);
+
+inline bool FFTSizeIsPow2(int length) {
+    return length > 0 && (length & (length - 1)) == 0;
+}
+
+#endif /* defined(__FFTBench__FFTSizes__) */
@@ -0,0 +1,101 @@
+//
+//  FFTStageHooks.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTStageHooks__
+#define __FFTBench__FFTStageHooks__
+
+/*
+ Timing hooks inside the vendored libraries (C and C++), for FFTStages.h.
+
+ The library sources only include this header when built with
+ FFTBENCH_STAGE_TIMING (cmake -DFFTBENCH_STAGE_TIMING=ON), otherwise they
+ define the two macros empty, so a normal build runs the unchanged code:
+
+    #ifdef FFTBENCH_STAGE_TIMING
+    #include "FFTStageHooks.h"
+    #else
+    #define FFT_STAGE_BEGIN(name)
+    #define FFT_STAGE_END(name, stage, level)
+    #endif
+
+    FFT_STAGE_BEGIN(t);
+    ... region ...
+    FFT_STAGE_END(t, FFTStageKissButterflies, depth);
+
+ A region adds its time stamp counter ticks (nanoseconds where there is no
+ counter) and one call to the bucket of (stage, level). The buckets are plain
+ globals: instrumented transforms must run on one thread at a time.
+ */
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+typedef enum {
+    FFTStageNSFFTButterflies = 0,  ///< srForwardMain / srBackwardMain of DFTUndiff_EXECUTE
+    FFTStageNSFFTBitReversal,      ///< cobra or recursive bit reversal
+    FFTStageNSFFTReal,             ///< realSub0 / realSub1 of the real transforms
+    FFTStagePFFFTPass,             ///< one radix pass of cfftf1_ps / rfftf1_ps / rfftb1_ps, level = pass index
+    FFTStagePFFFTFinalize,         ///< (un)interleave, finalize and preprocess of the SIMD layout
+    FFTStagePFFFTReorder,          ///< pffft_zreorder
+    FFTStageCkFFTLeaves,           ///< count 4 / count 8 leaves of fft_default, level = log2 count
+    FFTStageCkFFTButterflies,      ///< radix-4 / radix-2 recombination of fft_default, level = log2 count
+    FFTStageKissGather,            ///< the m == 1 input gather of kf_work, level = recursion depth
+    FFTStageKissButterflies,       ///< the kf_bfly* of kf_work, level = recursion depth
+    FFTStageOverhead,              ///< empty regions timed by FFTStagesRun to calibrate the hook cost
+    FFTStageCount
+} FFTStage;
+
+#define FFTStageMaxLevels 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uint64_t FFTStageTicks[FFTStageCount][FFTStageMaxLevels];
+extern uint64_t FFTStageCalls[FFTStageCount][FFTStageMaxLevels];
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline uint64_t FFTStageNow(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline void FFTStageAdd(int stage, int level, uint64_t start) {
+    uint64_t end = FFTStageNow();
+    if (level < 0) level = 0;
+    if (level >= FFTStageMaxLevels) level = FFTStageMaxLevels - 1;
+    FFTStageTicks[stage][level] += end - start;
+    FFTStageCalls[stage][level]++;
+}
+
+/// log2 of a power of 2, for levels given as a sub-transform size.
+static inline int FFTStageLog2(unsigned int n) {
+    int log2 = 0;
+    while (n > 1) {
+        n >>= 1;
+        log2++;
+    }
+    return log2;
+}
+
+#define FFT_STAGE_BEGIN(name) uint64_t name = FFTStageNow()
+#define FFT_STAGE_END(name, stage, level) FFTStageAdd((stage), (level), name)
+
+#endif /* defined(__FFTBench__FFTStageHooks__) */
@@ -0,0 +1,279 @@
+//
+//  FFTStages.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTStages.h"
+#include "FFTStageHooks.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <map>
+
+uint64_t FFTStageTicks[FFTStageCount][FFTStageMaxLevels];
+uint64_t FFTStageCalls[FFTStageCount][FFTStageMaxLevels];
+
+#if defined(FFTBENCH_STAGE_TIMING)
+
+// empty regions timed to calibrate the hook cost
+#define FFTStagesCalibrationRegions 100000
+
+
+struct FFTStageInfo {
+    const char *name;   ///< record direction
+    const char *kind;   ///< reorder, arith or mixed
+};
+
+static const FFTStageInfo FFTStagesInfo[FFTStageCount] = {
+    {"butterflies", "arith"},    // FFTStageNSFFTButterflies
+    {"bitreversal", "reorder"},  // FFTStageNSFFTBitReversal
+    {"realsub", "arith"},        // FFTStageNSFFTReal
+    {"pass", "arith"},           // FFTStagePFFFTPass
+    {"finalize", "mixed"},       // FFTStagePFFFTFinalize
+    {"zreorder", "reorder"},     // FFTStagePFFFTReorder
+    {"leaves", "arith"},         // FFTStageCkFFTLeaves
+    {"combine", "arith"},        // FFTStageCkFFTButterflies
+    {"gather", "reorder"},       // FFTStageKissGather
+    {"butterflies", "arith"},    // FFTStageKissButterflies
+    {"overhead", "other"},       // FFTStageOverhead
+};
+
+static const char *FFTStagesKinds[] = {"reorder", "arith", "mixed"};
+
+static bool FFTStagesIsInstrumented(const char *name) {
+    if (!strcmp(name, "kiss-simd")) return false; // built from kiss_fft.c without the hooks
+    const char *libraries[] = {"kiss", "pffft", "nsfft", "ckfft"};
+    for (size_t i = 0; i < sizeof(libraries) / sizeof(libraries[0]); i++) {
+        size_t n = strlen(libraries[i]);
+        if (!strncmp(name, libraries[i], n) && (name[n] == '\0' || name[n] == '-')) return true;
+    }
+    return false;
+}
+
+static void FFTStagesReset(void) {
+    memset(FFTStageTicks, 0, sizeof(FFTStageTicks));
+    memset(FFTStageCalls, 0, sizeof(FFTStageCalls));
+}
+
+/// Ticks of FFTStageNow() per nanosecond, from a 20 ms spin on both clocks.
+static double FFTStagesTicksPerNanosecond(void) {
+    uint64_t t0 = FFTTimerNanoseconds(), c0 = FFTStageNow(), t1;
+    do {
+        t1 = FFTTimerNanoseconds();
+    } while (t1 - t0 < 20000000);
+    uint64_t c1 = FFTStageNow();
+    return (double)(c1 - c0) / (double)(t1 - t0);
+}
+
+/// Ticks one empty region adds to its bucket, the least of a few rounds.
+static double FFTStagesOverheadTicks(void) {
+    double best = -1;
+    for (int round = 0; round < 5; round++) {
+        FFTStagesReset();
+        for (int i = 0; i < FFTStagesCalibrationRegions; i++) {
+            FFT_STAGE_BEGIN(empty);
+            FFT_STAGE_END(empty, FFTStageOverhead, 0);
+        }
+        double ticks = (double)FFTStageTicks[FFTStageOverhead][0] / FFTStagesCalibrationRegions;
+        if (best < 0 || ticks < best) best = ticks;
+    }
+    FFTStagesReset();
+    return best;
+}
+
+
+/// ns per transform of one region (stage, level) over the trials.
+struct FFTStageSamples {
+    double calls;                ///< regions per transform
+    std::vector<double> ns;
+    std::vector<double> shares;  ///< of the trial's total, so the shares of one trial add up to 1
+};
+
+typedef std::map<std::pair<int, int>, FFTStageSamples> FFTStageMap;
+
+static FFTTiming FFTStagesTiming(const std::vector<double> &ns, long batch) {
+    FFTTiming timing = FFTTiming();
+    timing.batch = batch;
+    timing.ns = FFTStatsCompute(ns);
+    timing.cycles = FFTStatsCompute(std::vector<double>());
+    return timing;
+}
+
+
+int FFTStagesRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> selected, backends;
+    if (!FFTBenchSelectBackends(options, selected)) return 1;
+    for (size_t b = 0; b < selected.size(); b++) {
+        if (!options.backends.empty() || FFTStagesIsInstrumented(selected[b]->name)) backends.push_back(selected[b]);
+    }
+    FFTBenchPrintEnvironment();
+    double ticksPerNs = FFTStagesTicksPerNanosecond();
+    double overhead = FFTStagesOverheadTicks();
+    printf("stages: forward ns per transform by region, hook cost %.1f ns per region subtracted\n",
+           overhead / ticksPerNs);
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::deque<std::string> levels; // record.stage strings
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        int length = lengths[l];
+        printf("%d-------\n", length);
+        std::vector<double> data_real(length), data_imag(length);
+        FFTSignalGenerate(options.signal, options.transform, options.precision, data_real.data(), data_imag.data(),
+                          length);
+
+        for (size_t b = 0; b < backends.size(); b++) {
+            const FFTBackendInfo *info = backends[b];
+            std::string label = std::string(info->name) + ":";
+            FFTBackend *backend = info->create();
+            if (!backend->supports(length)) {
+                delete backend;
+                continue;
+            }
+            FFTRecord record = FFTRecord();
+            record.backend = info->name;
+            record.length = length;
+            record.precision = info->precision;
+            record.transform = info->transform;
+            record.threads = 1;
+            record.premarshal = true;
+            record.peakBytes = -1;
+            if (!backend->setup(length)) {
+                printf("%-6s setup failed\n", label.c_str());
+                backend->teardown();
+                delete backend;
+                record.direction = "fwd";
+                record.status = FFTBenchStatusSetupFailed;
+                records.push_back(record);
+                failures++;
+                continue;
+            }
+            FFTLayout layout = backend->layout();
+            record.inPlace = FFTLayoutIsInPlace(layout);
+            record.status = FFTBenchStatusOK;
+
+            // in-place backends get their input back before every call, outside the timed region
+            FFTBufferImage image;
+            FFTBufferLoad(layout.input, layout.precision, data_real.data(), data_imag.data(), length);
+            image.capture(layout.input, layout.precision, length, layout.lanes);
+            bool restore = record.inPlace;
+            int trials = options.timer.trials > 0 ? options.timer.trials : 1;
+            long batch = std::max(options.points / length / trials, 1L);
+            for (long r = 0; r < batch; r++) { // warmup
+                if (restore) image.restore();
+                backend->forward();
+            }
+
+            FFTStageMap stages;
+            std::vector<double> total(trials), other(trials), otherShares(trials);
+            std::vector<std::vector<double> > kindShares(3, std::vector<double>(trials, 0));
+            for (int t = 0; t < trials; t++) {
+                FFTStagesReset();
+                uint64_t ticks = 0;
+                for (long r = 0; r < batch; r++) {
+                    if (restore) image.restore();
+                    uint64_t t0 = FFTStageNow();
+                    backend->forward();
+                    ticks += FFTStageNow() - t0;
+                }
+                double inside = 0, regions = 0, net = 0;
+                for (int s = 0; s < FFTStageOverhead; s++) {
+                    for (int v = 0; v < FFTStageMaxLevels; v++) {
+                        if (!FFTStageCalls[s][v]) continue;
+                        double calls = (double)FFTStageCalls[s][v];
+                        double ticksIn = std::max((double)FFTStageTicks[s][v] - calls * overhead, 0.0);
+                        FFTStageSamples &samples = stages[std::make_pair(s, v)];
+                        samples.calls = calls / batch;
+                        samples.ns.resize(trials);
+                        samples.ns[t] = ticksIn / ticksPerNs / batch;
+                        inside += (double)FFTStageTicks[s][v];
+                        net += ticksIn;
+                        regions += calls;
+                    }
+                }
+                // a region costs its caller about `overhead` more than it measures: the first counter read
+                // and the bucket update
+                double outside = std::max((double)ticks - inside - regions * overhead, 0.0);
+                double whole = net + outside > 0 ? net + outside : 1;
+                total[t] = (net + outside) / ticksPerNs / batch;
+                other[t] = outside / ticksPerNs / batch;
+                otherShares[t] = outside / whole;
+                for (FFTStageMap::iterator it = stages.begin(); it != stages.end(); ++it) {
+                    FFTStageSamples &samples = it->second;
+                    samples.shares.resize(trials);
+                    samples.shares[t] = samples.ns[t] * ticksPerNs * batch / whole;
+                    for (int k = 0; k < 3; k++) {
+                        if (!strcmp(FFTStagesInfo[it->first.first].kind, FFTStagesKinds[k])) {
+                            kindShares[k][t] += samples.shares[t];
+                        }
+                    }
+                }
+            }
+            backend->teardown();
+            delete backend;
+
+            // shares are medians of the per-trial fractions, not ratios of the medians
+            FFTTiming totalTiming = FFTStagesTiming(total, batch);
+            printf("%-6s %-12s %-7s %5s %10s %12s %6s\n", label.c_str(), "region", "kind", "level", "calls",
+                   "ns", "%");
+            for (FFTStageMap::iterator it = stages.begin(); it != stages.end(); ++it) {
+                const FFTStageInfo &stage = FFTStagesInfo[it->first.first];
+                FFTTiming timing = FFTStagesTiming(it->second.ns, batch);
+                printf("%-6s %-12s %-7s %5d %10.1f %12.1f %6.1f\n", "", stage.name, stage.kind, it->first.second,
+                       it->second.calls, timing.ns.median, FFTStatsCompute(it->second.shares).median * 100);
+
+                levels.push_back(std::to_string(it->first.second));
+                record.direction = stage.name;
+                record.timing = timing;
+                record.stage = levels.back().c_str();
+                record.stride = (long)(it->second.calls + 0.5);
+                record.butterflies = 0;
+                records.push_back(record);
+            }
+            if (stages.empty()) printf("%-6s no instrumented regions ran\n", "");
+
+            FFTTiming otherTiming = FFTStagesTiming(other, batch);
+            double otherShare = FFTStatsCompute(otherShares).median;
+            printf("%-6s %-12s %-7s %5s %10s %12.1f %6.1f\n", "", "other", "", "", "", otherTiming.ns.median,
+                   otherShare * 100);
+            printf("%-6s %-12s %-7s %5s %10s %12.1f\n", "", "total", "", "", "", totalTiming.ns.median);
+            printf("%-6s", "");
+            for (int k = 0; k < 3; k++) {
+                double share = FFTStatsCompute(kindShares[k]).median;
+                if (share > 0) printf(" %s %.1f%%", FFTStagesKinds[k], share * 100);
+            }
+            printf(" other %.1f%%\n", otherShare * 100);
+
+            record.stage = NULL;
+            record.stride = 0;
+            record.direction = "other";
+            record.timing = otherTiming;
+            records.push_back(record);
+            record.direction = "total";
+            record.timing = totalTiming;
+            records.push_back(record);
+        }
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
+
+#else
+
+int FFTStagesRun(const FFTBenchOptions &options) {
+    (void)options;
+    fprintf(stderr, "the libraries are built without stage timing, configure with -DFFTBENCH_STAGE_TIMING=ON\n");
+    return 1;
+}
+
+#endif
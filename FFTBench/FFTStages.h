@@ -0,0 +1,44 @@
+//
+//  FFTStages.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTStages__
+#define __FFTBench__FFTStages__
+
+#include "FFTBench.h"
+
+/*
+ Where the time of a forward transform goes, from timing hooks inside the
+ libraries (FFTStageHooks.h). They are compiled in only by
+
+    cmake -S . -B build-stages -DFFTBENCH_STAGE_TIMING=ON
+    ./build-stages/FFTBench --stages
+    ./build-stages/FFTBench --stages -b pffft --min-log2 12 --max-log2 22
+
+ and split each call into regions, a level being the pass, recursion depth or
+ sub-transform size the region ran at:
+
+    nsfft    bit reversal, split radix butterflies, real pre/post processing
+    pffft    each radix pass, (un)interleave/finalize, zreorder
+    ckfft    count 4/8 leaves and radix-4 recombination per log2 count
+    kiss     m == 1 input gather and butterflies per recursion depth
+
+ Regions are marked reorder (only moving data), arith (butterflies) or mixed;
+ the per-backend summary adds them up, so a slowdown past some length shows as
+ the reorder share growing or the arithmetic one. Time outside the regions
+ (calls, copies, plan lookups) is `other`. One region costs two time stamp
+ counter reads, calibrated on empty regions and subtracted from the regions,
+ `other` and the total; small lengths with many short regions (kiss, ckfft)
+ are still skewed by what the calibration misses.
+
+ Default backends are the instrumented ones: kiss, pffft, nsfft, ckfft and
+ their real/double variants of the track.
+ */
+
+/// Run the stage breakdown over the lengths of options, return the number of failures.
+int FFTStagesRun(const FFTBenchOptions &options);
+
+#endif /* defined(__FFTBench__FFTStages__) */
@@ -0,0 +1,209 @@
+//
+//  FFTThroughput.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTThroughput.h"
+#include "FFTReport.h"
+#include "FFTBaseline.h"
+#include "FFTBackend.h"
+#include "FFTTimer.h"
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+struct FFTThroughputWorker {
+    FFTBackend *backend;
+    long iterations;
+};
+
+struct FFTThroughputShared {
+    int length;
+    const double *data_real;
+    const double *data_imag;
+    std::mutex *lock;              ///< non-NULL: backend is not reentrant
+    std::atomic<int> ready;
+    std::atomic<bool> go;
+    std::atomic<bool> stop;
+};
+
+
+static bool FFTThroughputPin(std::thread &thread, int index) {
+#if defined(__linux__)
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)index;
+    return false;
+#endif
+}
+
+
+static void FFTThroughputLoop(FFTThroughputWorker *worker, FFTThroughputShared *shared) {
+    FFTBackend *backend = worker->backend;
+    FFTLayout layout = backend->layout();
+    int length = shared->length;
+    long iterations = 0;
+
+    shared->ready++;
+    while (!shared->go.load(std::memory_order_acquire)) {}
+
+    while (!shared->stop.load(std::memory_order_relaxed)) {
+        FFTBufferLoad(layout.input, layout.precision, shared->data_real, shared->data_imag, length);
+        if (shared->lock) {
+            std::lock_guard<std::mutex> guard(*shared->lock);
+            backend->forward();
+            backend->inverse();
+        } else {
+            backend->forward();
+            backend->inverse();
+        }
+        iterations++;
+    }
+    worker->iterations = iterations;
+}
+
+
+/// Transforms per second with `count` threads, -1 if an instance could not be set up.
+static double FFTThroughputMeasure(const FFTBackendInfo *info, int length, int count,
+                                   const double *data_real, const double *data_imag,
+                                   const FFTBenchOptions &options, const char **mode, bool *inPlace) {
+    std::vector<FFTThroughputWorker> workers(count);
+    bool ok = true;
+    bool shared = options.sharedSetup;
+
+    // plans are created on this thread, planners are not thread-safe
+    workers[0].backend = info->create();
+    ok = workers[0].backend->setup(length);
+    for (int i = 1; i < count; i++) {
+        workers[i].backend = info->create();
+        if (shared && !workers[i].backend->setupShared(workers[0].backend, length)) {
+            workers[i].backend->teardown();
+            shared = false;
+        }
+        if (!shared && !workers[i].backend->setup(length)) ok = false;
+    }
+    if (count == 1) shared = false;
+    *mode = shared ? "shared" : "private";
+    *inPlace = ok && FFTLayoutIsInPlace(workers[0].backend->layout());
+
+    double rate = -1;
+    if (ok) {
+        std::mutex lock;
+        FFTThroughputShared state;
+        state.length = length;
+        state.data_real = data_real;
+        state.data_imag = data_imag;
+        state.lock = workers[0].backend->isReentrant() ? NULL : &lock;
+        state.ready = 0;
+        state.go = false;
+        state.stop = false;
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < count; i++) {
+            workers[i].iterations = 0;
+            threads.push_back(std::thread(FFTThroughputLoop, &workers[i], &state));
+            if (options.pinThreads && !FFTThroughputPin(threads.back(), i) && i == 0) {
+                fprintf(stderr, "thread pinning not supported here\n");
+            }
+        }
+        while (state.ready.load() < count) std::this_thread::yield();
+
+        uint64_t t0 = FFTTimerNanoseconds();
+        state.go.store(true, std::memory_order_release);
+        std::this_thread::sleep_for(std::chrono::microseconds((long)(options.seconds * 1e6)));
+        state.stop.store(true);
+        for (int i = 0; i < count; i++) threads[i].join();
+        uint64_t t1 = FFTTimerNanoseconds();
+
+        long iterations = 0;
+        for (int i = 0; i < count; i++) iterations += workers[i].iterations;
+        rate = iterations * 2 / ((t1 - t0) * 1e-9); // forward + inverse
+        if (state.lock) *mode = shared ? "shared, serialized" : "private, serialized";
+    }
+
+    // shared instances first, the owner frees the plan last
+    for (int i = count - 1; i >= 0; i--) {
+        workers[i].backend->teardown();
+        delete workers[i].backend;
+    }
+    return rate;
+}
+
+
+int FFTThroughputRun(const FFTBenchOptions &options) {
+    std::vector<const FFTBackendInfo *> backends;
+    if (!FFTBenchSelectBackends(options, backends)) return 1;
+    FFTBenchPrintEnvironment();
+    printf("throughput: %s plans%s, %.2f s per cell\n", options.sharedSetup ? "shared" : "private",
+           options.pinThreads ? ", pinned" : "", options.seconds);
+
+    int failures = 0;
+    std::vector<FFTRecord> records;
+    std::vector<int> lengths = FFTBenchLengths(options);
+    for (size_t l = 0; l < lengths.size(); l++) {
+        int length = lengths[l];
+        printf("%d-------\n", length);
+
+        std::vector<double> data_real(length), data_imag(length);
+        FFTBenchGenerateInput(data_real.data(), data_imag.data(), length);
+
+        for (size_t b = 0; b < backends.size(); b++) {
+            std::string label = std::string(backends[b]->name) + ":";
+            FFTBackend *probe = backends[b]->create();
+            bool supported = probe->supports(length);
+            delete probe;
+            if (!supported) continue;
+
+            double base = 0;
+            for (size_t t = 0; t < options.threads.size(); t++) {
+                int count = options.threads[t];
+                const char *mode = "";
+                bool inPlace = false;
+                double rate = FFTThroughputMeasure(backends[b], length, count, data_real.data(),
+                                                   data_imag.data(), options, &mode, &inPlace);
+                FFTRecord record = FFTRecord();
+                record.backend = backends[b]->name;
+                record.length = length;
+                record.precision = backends[b]->precision;
+                record.transform = backends[b]->transform;
+                record.inPlace = inPlace;
+                record.direction = "roundtrip";
+                record.threads = count;
+                if (rate < 0) {
+                    printf("%-6s %3d thr  setup failed\n", label.c_str(), count);
+                    record.status = FFTBenchStatusSetupFailed;
+                    records.push_back(record);
+                    failures++;
+                    break;
+                }
+                record.status = FFTBenchStatusOK;
+                record.mfftPerSecond = rate * 1e-6;
+                records.push_back(record);
+                if (t == 0) base = rate / count;
+                printf("%-6s %3d thr  %10.3f Mfft/s  x%5.2f  %3.0f%%  (%s)\n", label.c_str(), count,
+                       rate * 1e-6, rate / base, rate / base / count * 100, mode);
+            }
+        }
+    }
+
+    if (!FFTReportWrite(options, records)) failures++;
+    failures += FFTBaselineCheck(options, records);
+    return failures;
+}
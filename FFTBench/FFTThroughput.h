@@ -0,0 +1,31 @@
+//
+//  FFTThroughput.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTThroughput__
+#define __FFTBench__FFTThroughput__
+
+#include "FFTBench.h"
+
+/*
+ Multi-threaded throughput: K threads, each with private buffers, run
+
+    for() {
+      input();
+      fft();
+      ifft();
+    }
+
+ for a fixed wall time. Plans are private per thread, or shared by all threads
+ (options.sharedSetup) when the library's plan is read-only. Backends with
+ global scratch (fftn) are serialized with a lock, which is what production
+ code would have to do.
+ */
+
+/// Run the throughput sweep over options.threads, return the number of failures.
+int FFTThroughputRun(const FFTBenchOptions &options);
+
+#endif /* defined(__FFTBench__FFTThroughput__) */
@@ -0,0 +1,91 @@
+//
+//  FFTTimer.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTTimer.h"
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define FFTTIMER_HAS_TSC 1
+#endif
+
+
+uint64_t FFTTimerNanoseconds(void) {
+#if defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) mach_timebase_info(&timebase);
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+uint64_t FFTTimerCycles(void) {
+#if FFTTIMER_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+bool FFTTimerHasCycles(void) {
+#if FFTTIMER_HAS_TSC
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/// linear interpolation between closest ranks, `sorted` must not be empty
+static double FFTStatsPercentile(const std::vector<double> &sorted, double p) {
+    double rank = p * (sorted.size() - 1);
+    size_t lo = (size_t)floor(rank);
+    size_t hi = (size_t)ceil(rank);
+    double frac = rank - lo;
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+FFTStats FFTStatsCompute(std::vector<double> samples) {
+    FFTStats stats;
+    memset(&stats, 0, sizeof(stats));
+    int n = (int)samples.size();
+    stats.count = n;
+    if (n == 0) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += samples[i];
+
+    stats.min = samples[0];
+    stats.max = samples[n - 1];
+    stats.mean = sum / n;
+    stats.median = FFTStatsPercentile(samples, 0.5);
+    stats.p90 = FFTStatsPercentile(samples, 0.9);
+    stats.p99 = FFTStatsPercentile(samples, 0.99);
+    stats.p999 = FFTStatsPercentile(samples, 0.999);
+
+    // ranks n/2 -+ 1.96*sqrt(n)/2 bound the median with ~95% confidence
+    double half = 0.98 * sqrt((double)n);
+    int lo = (int)floor(n / 2.0 - half);
+    int hi = (int)ceil(n / 2.0 + half);
+    if (lo < 0) lo = 0;
+    if (hi > n - 1) hi = n - 1;
+    stats.ciLow = samples[lo];
+    stats.ciHigh = samples[hi];
+    return stats;
+}
@@ -0,0 +1,115 @@
+//
+//  FFTTimer.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTTimer__
+#define __FFTBench__FFTTimer__
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+/*
+ Statistical timer, replaces the single gettimeofday() pair of ProfileTime.
+
+    warmup:  block(warmup)               not recorded
+    trials:  block(batch) x trials       one sample per trial = elapsed / batch
+
+ With a time budget the batch is not fixed: one timed block(1) estimates the
+ cost of an iteration, then batch (and for transforms slower than
+ budget / trials, the number of trials, down to FFTTimerMinTrials) is chosen
+ so that all trials together take about `budget` seconds.
+
+ Samples come from a monotonic nanosecond clock, and optionally from the CPU
+ time stamp counter (x86 only).
+ */
+
+/// Monotonic clock in nanoseconds.
+uint64_t FFTTimerNanoseconds(void);
+
+/// Time stamp counter, 0 if not available on this CPU.
+uint64_t FFTTimerCycles(void);
+
+/// Whether FFTTimerCycles() returns something useful.
+bool FFTTimerHasCycles(void);
+
+
+/// Order statistics of a set of samples.
+struct FFTStats {
+    int count;
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double p999;
+    double max;
+    double mean;
+    double ciLow;    ///< 95% confidence interval of the median (distribution free)
+    double ciHigh;
+};
+
+FFTStats FFTStatsCompute(std::vector<double> samples);
+
+
+/// fewest trials a time budget may cut a measurement down to
+#define FFTTimerMinTrials 3
+
+struct FFTTimerOptions {
+    long warmup;   ///< iterations run before the first trial
+    int trials;    ///< independent samples
+    bool cycles;   ///< also sample the time stamp counter
+    double budget; ///< seconds for all trials of one measurement, 0: fixed batch
+
+    FFTTimerOptions() : warmup(-1), trials(32), cycles(false), budget(0) {}
+};
+
+/// Per-iteration timing of one measured operation.
+struct FFTTiming {
+    long batch;        ///< iterations per trial
+    FFTStats ns;       ///< nanoseconds per iteration
+    FFTStats cycles;   ///< cycles per iteration, count == 0 if not sampled
+};
+
+
+/// Measure `block(n)`, which must run its operation n times. warmup < 0 means one batch.
+/// With options.budget the given batch is ignored; the calibration call counts as warmup.
+template <typename Block>
+FFTTiming FFTTimerMeasure(const FFTTimerOptions &options, long batch, Block block) {
+    if (batch < 1) batch = 1;
+    int trials = options.trials > 0 ? options.trials : 1;
+    bool cycles = options.cycles && FFTTimerHasCycles();
+
+    long warmup = options.warmup < 0 ? batch : options.warmup;
+    if (options.budget > 0) {
+        uint64_t t0 = FFTTimerNanoseconds();
+        block(1);
+        double single = (double)(FFTTimerNanoseconds() - t0) + 1;
+        double budget = options.budget * 1e9;
+        if (single * trials > budget) trials = std::max((int)(budget / single), std::min(trials, FFTTimerMinTrials));
+        batch = std::max((long)(budget / trials / single), 1L);
+        warmup = options.warmup < 0 ? batch - 1 : options.warmup - 1;
+    }
+    if (warmup > 0) block(warmup);
+
+    std::vector<double> ns(trials), cy(cycles ? trials : 0);
+    for (int t = 0; t < trials; t++) {
+        uint64_t c0 = cycles ? FFTTimerCycles() : 0;
+        uint64_t t0 = FFTTimerNanoseconds();
+        block(batch);
+        uint64_t t1 = FFTTimerNanoseconds();
+        uint64_t c1 = cycles ? FFTTimerCycles() : 0;
+        ns[t] = (double)(t1 - t0) / batch;
+        if (cycles) cy[t] = (double)(c1 - c0) / batch;
+    }
+
+    FFTTiming timing;
+    timing.batch = batch;
+    timing.ns = FFTStatsCompute(ns);
+    timing.cycles = FFTStatsCompute(cy);
+    return timing;
+}
+
+#endif /* defined(__FFTBench__FFTTimer__) */
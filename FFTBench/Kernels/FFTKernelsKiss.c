@@ -0,0 +1,84 @@
+//
+//  FFTKernelsKiss.c
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+// the kissfft library target is built from this file (kf_bfly* are static)
+#include "kiss_fft.c"
+#include "FFTKernelsShim.h"
+
+#include <string.h>
+
+typedef struct {
+    kiss_fft_cfg cfg;
+    kiss_fft_cpx *data;
+    int p;
+    int m;
+} FFTKernelsKissState;
+
+static void FFTKernelsKissRun(const FFTKernelPass *pass, long repeats) {
+    const FFTKernelsKissState *s = (const FFTKernelsKissState *)pass->state;
+    size_t fstride = (size_t)pass->stride;
+    long r;
+    size_t c;
+    for (r = 0; r < repeats; r++) {
+        // the fstride sub-transforms of the stage, each recombining p DFTs of size m
+        for (c = 0; c < fstride; c++) {
+            kiss_fft_cpx *Fout = s->data + c * s->p * s->m;
+            switch (s->p) {
+                case 2: kf_bfly2(Fout, fstride, s->cfg, s->m); break;
+                case 3: kf_bfly3(Fout, fstride, s->cfg, s->m); break;
+                case 4: kf_bfly4(Fout, fstride, s->cfg, s->m); break;
+                case 5: kf_bfly5(Fout, fstride, s->cfg, s->m); break;
+                default: kf_bfly_generic(Fout, fstride, s->cfg, s->m, s->p); break;
+            }
+        }
+    }
+}
+
+static void FFTKernelsKissRelease(FFTKernelPass *pass) {
+    FFTKernelsKissState *s = (FFTKernelsKissState *)pass->state;
+    KISS_FFT_FREE(s->data);
+    KISS_FFT_FREE(s->cfg);
+    KISS_FFT_FREE(s);
+    pass->state = NULL;
+}
+
+int FFTKernelsKissPrepare(int radix, int length, FFTKernelStage stage, FFTKernelPass *pass) {
+    kiss_fft_cfg cfg = kiss_fft_alloc(length, 0, NULL, NULL);
+    if (!cfg) return 0;
+
+    // factors are (p, m) pairs from the outermost stage (fstride 1) inwards; kf_work runs them innermost first
+    int found = -1, fstride = 1, fstrideFound = 0, i;
+    for (i = 0;; i++) {
+        int p = cfg->factors[2 * i];
+        if (p == radix && (found < 0 || stage == FFTKernelStageFirst)) {
+            found = i;
+            fstrideFound = fstride;
+        }
+        fstride *= p;
+        if (cfg->factors[2 * i + 1] == 1) break;
+    }
+    if (found < 0) {
+        KISS_FFT_FREE(cfg);
+        return 0;
+    }
+
+    FFTKernelsKissState *s = (FFTKernelsKissState *)KISS_FFT_MALLOC(sizeof(FFTKernelsKissState));
+    s->cfg = cfg;
+    s->data = (kiss_fft_cpx *)KISS_FFT_MALLOC(sizeof(kiss_fft_cpx) * length);
+    memset(s->data, 0, sizeof(kiss_fft_cpx) * length);
+    s->p = cfg->factors[2 * found];
+    s->m = cfg->factors[2 * found + 1];
+
+    pass->state = s;
+    pass->stage = stage == FFTKernelStageFirst ? "first" : "last";
+    pass->calls = fstrideFound;
+    pass->stride = fstrideFound;
+    pass->butterflies = (long)length / s->p;
+    pass->run = FFTKernelsKissRun;
+    pass->release = FFTKernelsKissRelease;
+    return 1;
+}
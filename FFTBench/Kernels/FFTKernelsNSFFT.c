@@ -0,0 +1,59 @@
+//
+//  FFTKernelsNSFFT.c
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include <stdint.h>
+
+#include "SIMDBase.h"
+#include "FFTKernelsShim.h"
+
+// one per mode object built from FFTKernelsNSFFTUndiff.c
+#define FFTKERNELS_NSFFT_DECLARE(name) \
+    int FFTKernelsNSFFTPrepare_##name(int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass);
+FFTKERNELS_NSFFT_DECLARE(purec_float)
+FFTKERNELS_NSFFT_DECLARE(purec_double)
+FFTKERNELS_NSFFT_DECLARE(purec_longdouble)
+FFTKERNELS_NSFFT_DECLARE(sse_float)
+FFTKERNELS_NSFFT_DECLARE(sse2_double)
+FFTKERNELS_NSFFT_DECLARE(neon_float)
+FFTKERNELS_NSFFT_DECLARE(avx_float)
+FFTKERNELS_NSFFT_DECLARE(avx_double)
+FFTKERNELS_NSFFT_DECLARE(altivec_float)
+
+int FFTKernelsNSFFTPrepare(int mode, int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass) {
+    if (SIMDBase_detect(mode) != 1) return 0;
+    switch (mode) {
+#ifdef ENABLE_PUREC_FLOAT
+        case SIMDBase_MODE_PUREC_FLOAT: return FFTKernelsNSFFTPrepare_purec_float(kernel, length, stage, pass);
+#endif
+#ifdef ENABLE_PUREC_DOUBLE
+        case SIMDBase_MODE_PUREC_DOUBLE: return FFTKernelsNSFFTPrepare_purec_double(kernel, length, stage, pass);
+#endif
+#ifdef ENABLE_PUREC_LONGDOUBLE
+        case SIMDBase_MODE_PUREC_LONGDOUBLE:
+            return FFTKernelsNSFFTPrepare_purec_longdouble(kernel, length, stage, pass);
+#endif
+#ifdef ENABLE_SSE_FLOAT
+        case SIMDBase_MODE_SSE_FLOAT: return FFTKernelsNSFFTPrepare_sse_float(kernel, length, stage, pass);
+#endif
+#ifdef ENABLE_SSE2_DOUBLE
+        case SIMDBase_MODE_SSE2_DOUBLE: return FFTKernelsNSFFTPrepare_sse2_double(kernel, length, stage, pass);
+#endif
+#ifdef ENABLE_NEON_FLOAT
+        case SIMDBase_MODE_NEON_FLOAT: return FFTKernelsNSFFTPrepare_neon_float(kernel, length, stage, pass);
+#endif
+#ifdef ENABLE_AVX_FLOAT
+        case SIMDBase_MODE_AVX_FLOAT: return FFTKernelsNSFFTPrepare_avx_float(kernel, length, stage, pass);
+#endif
+#ifdef ENABLE_AVX_DOUBLE
+        case SIMDBase_MODE_AVX_DOUBLE: return FFTKernelsNSFFTPrepare_avx_double(kernel, length, stage, pass);
+#endif
+#ifdef ENABLE_ALTIVEC_FLOAT
+        case SIMDBase_MODE_ALTIVEC_FLOAT: return FFTKernelsNSFFTPrepare_altivec_float(kernel, length, stage, pass);
+#endif
+        default: return 0;
+    }
+}
@@ -0,0 +1,122 @@
+//
+//  FFTKernelsNSFFTUndiff.c
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+// the per-mode nsfft objects are built from this file in place of DFTUndiff.c (its butterflies are static);
+// FFTKernelsNSFFT.c dispatches to the FFTKernelsNSFFTPrepare_<mode> functions like DFT.c does
+#include "DFTUndiff.c"
+#include "FFTKernelsShim.h"
+
+#include <string.h>
+
+#if defined(ENABLE_PUREC_FLOAT)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_purec_float
+#elif defined(ENABLE_PUREC_DOUBLE)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_purec_double
+#elif defined(ENABLE_PUREC_LONGDOUBLE)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_purec_longdouble
+#elif defined(ENABLE_SSE_FLOAT)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_sse_float
+#elif defined(ENABLE_SSE2_DOUBLE)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_sse2_double
+#elif defined(ENABLE_NEON_FLOAT)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_neon_float
+#elif defined(ENABLE_AVX_FLOAT)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_avx_float
+#elif defined(ENABLE_AVX_DOUBLE)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_avx_double
+#elif defined(ENABLE_ALTIVEC_FLOAT)
+#define FFTKernelsNSFFTPrepareMode FFTKernelsNSFFTPrepare_altivec_float
+#endif
+
+int FFTKernelsNSFFTPrepareMode(int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass);
+
+
+typedef struct {
+    DFTUndiff *plan;
+    SIMDBase_VECT *data;
+    int kernel;
+} FFTKernelsNSFFTState;
+
+static void FFTKernelsNSFFTRun(const FFTKernelPass *pass, long repeats) {
+    const FFTKernelsNSFFTState *s = (const FFTKernelsNSFFTState *)pass->state;
+    DFTUndiff *p = s->plan;
+    int32_t vectors = (int32_t)p->length * 2, o;
+    long r;
+    p->s = s->data;
+    for (r = 0; r < repeats; r++) {
+        switch (s->kernel) {
+            case FFTKernelsNSFFTButForward16: // the leaves of srForwardMain2, each 16 points in 32 vectors
+                for (o = 0; o < vectors; o += 32) {
+                    p->offset1 = o;
+                    srButForward16(p);
+                }
+                break;
+            case FFTKernelsNSFFTButForward32:
+                for (o = 0; o < vectors; o += 64) {
+                    p->offset1 = o;
+                    srButForward32(p);
+                }
+                break;
+            default:
+                bitReversalCobraInplace(p);
+                break;
+        }
+    }
+}
+
+static void FFTKernelsNSFFTRelease(FFTKernelPass *pass) {
+    FFTKernelsNSFFTState *s = (FFTKernelsNSFFTState *)pass->state;
+    DFTUndiff_DESTROYPLAN(s->plan);
+    SIMDBase_alignedFree(s->data);
+    free(s);
+    pass->state = NULL;
+}
+
+int FFTKernelsNSFFTPrepareMode(int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass) {
+    int leaf = kernel == FFTKernelsNSFFTButForward32 ? 32 : 16;
+    if (stage != FFTKernelStageFirst || length < leaf || (length & (length - 1))) return 0;
+    DFTUndiff *plan = DFTUndiff_MAKEPLANSUB(length, length * 2, kernel == FFTKernelsNSFFTBitReversalCobra, 0);
+    int lanes = (int)(sizeof(SIMDBase_VECT) / sizeof(SIMDBase_REAL));
+
+    if (kernel == FFTKernelsNSFFTBitReversalCobra && !plan->useCobra) {
+        // the plan only builds the tables from 2^(2 cobraQ) points, with cobraQ sized to the whole data
+        // cache; below that the same tile loop is run with the largest tile the length allows
+        int32_t q = (int32_t)plan->log2len / 2, i;
+        if (q > plan->cobraQ) q = plan->cobraQ;
+        if (q < 4) { // rows are copied 16 complex vectors at a time
+            DFTUndiff_DESTROYPLAN(plan);
+            return 0;
+        }
+        plan->cobraQ = q;
+        plan->cobraT = SIMDBase_alignedMalloc(sizeof(SIMDBase_VECT) * 2 * (1 << (q * 2)));
+        plan->cobraR = (int32_t *)SIMDBase_alignedMalloc(sizeof(int32_t) * (1 << q));
+        for (i = 0; i < (1 << q); i++) plan->cobraR[i] = bitR(i, q);
+        plan->useCobra = 1;
+    }
+
+    FFTKernelsNSFFTState *s = (FFTKernelsNSFFTState *)malloc(sizeof(FFTKernelsNSFFTState));
+    s->plan = plan;
+    s->data = SIMDBase_alignedMalloc(sizeof(SIMDBase_VECT) * length * 2);
+    memset(s->data, 0, sizeof(SIMDBase_VECT) * length * 2);
+    s->kernel = kernel;
+
+    pass->state = s;
+    if (kernel == FFTKernelsNSFFTBitReversalCobra) {
+        pass->stage = "all";
+        pass->calls = 1;
+        pass->stride = 1L << plan->cobraQ;
+        pass->butterflies = (long)length * lanes; // points moved
+    } else {
+        pass->stage = "leaf";
+        pass->calls = length / leaf;
+        pass->stride = leaf / 2;
+        pass->butterflies = (long)length / 2 * (leaf == 16 ? 4 : 5) * lanes; // radix-2 equivalents
+    }
+    pass->run = FFTKernelsNSFFTRun;
+    pass->release = FFTKernelsNSFFTRelease;
+    return 1;
+}
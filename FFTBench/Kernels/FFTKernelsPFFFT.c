@@ -0,0 +1,112 @@
+//
+//  FFTKernelsPFFFT.c
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+// the pffft library target is built from this file (the radix passes are static)
+#include "pffft.c"
+#include "FFTKernelsShim.h"
+
+#include <string.h>
+
+typedef struct {
+    PFFFT_Setup *setup;
+    v4sf *in;
+    v4sf *out;
+    int kernel;
+    int ido;
+    int l1;
+    const float *wa[4];
+} FFTKernelsPFFFTState;
+
+static void FFTKernelsPFFFTRun(const FFTKernelPass *pass, long repeats) {
+    const FFTKernelsPFFFTState *s = (const FFTKernelsPFFFTState *)pass->state;
+    long r;
+    for (r = 0; r < repeats; r++) {
+        switch (s->kernel) {
+            case FFTKernelsPFFFTPassf4:
+                passf4_ps(s->ido, s->l1, s->in, s->out, s->wa[0], s->wa[1], s->wa[2], -1);
+                break;
+            case FFTKernelsPFFFTPassf5:
+                passf5_ps(s->ido, s->l1, s->in, s->out, s->wa[0], s->wa[1], s->wa[2], s->wa[3], -1);
+                break;
+            case FFTKernelsPFFFTRadf4:
+                radf4_ps(s->ido, s->l1, s->in, s->out, s->wa[0], s->wa[1], s->wa[2]);
+                break;
+            default:
+                radb4_ps(s->ido, s->l1, s->in, s->out, s->wa[0], s->wa[1], s->wa[2]);
+                break;
+        }
+    }
+}
+
+static void FFTKernelsPFFFTRelease(FFTKernelPass *pass) {
+    FFTKernelsPFFFTState *s = (FFTKernelsPFFFTState *)pass->state;
+    pffft_aligned_free(s->in);
+    pffft_aligned_free(s->out);
+    pffft_destroy_setup(s->setup);
+    free(s);
+    pass->state = NULL;
+}
+
+int FFTKernelsPFFFTPrepare(int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass) {
+    int real = kernel == FFTKernelsPFFFTRadf4 || kernel == FFTKernelsPFFFTRadb4;
+    int radix = kernel == FFTKernelsPFFFTPassf5 ? 5 : 4;
+    PFFFT_Setup *setup = pffft_new_setup(length, real ? PFFFT_REAL : PFFFT_COMPLEX);
+    if (!setup) return 0;
+
+    // the stage loops of cfftf1_ps, rfftf1_ps and rfftb1_ps in their execution order; the first
+    // stage with this radix is kept for FFTKernelStageFirst, the last one for FFTKernelStageLast
+    const float *wa = setup->twiddle;
+    const int *ifac = setup->ifac;
+    int n = real ? setup->Ncvec * 2 : setup->Ncvec;
+    int nf = ifac[1], k1, found = 0, ido = 0, l1 = 0, iw = 0;
+    if (kernel == FFTKernelsPFFFTRadf4) {
+        int l2 = n, w = n - 1;
+        for (k1 = 1; k1 <= nf; k1++) {
+            int ip = ifac[nf - k1 + 2], l = l2 / ip, d = n / l2;
+            w -= (ip - 1) * d;
+            if (ip == radix && (!found || stage == FFTKernelStageLast)) {
+                found = 1; ido = d; l1 = l; iw = w;
+            }
+            l2 = l;
+        }
+    } else {
+        int l = 1, w = 0;
+        for (k1 = 1; k1 <= nf; k1++) {
+            int ip = ifac[k1 + 1], l2 = ip * l, d = real ? n / l2 : 2 * (n / l2); // complex: ido counts floats
+            if (ip == radix && (!found || stage == FFTKernelStageLast)) {
+                found = 1; ido = d; l1 = l; iw = w;
+            }
+            l = l2;
+            w += (ip - 1) * d;
+        }
+    }
+    if (!found) {
+        pffft_destroy_setup(setup);
+        return 0;
+    }
+
+    FFTKernelsPFFFTState *s = (FFTKernelsPFFFTState *)malloc(sizeof(FFTKernelsPFFFTState));
+    int vectors = 2 * setup->Ncvec, i;
+    s->setup = setup;
+    s->in = (v4sf *)pffft_aligned_malloc(sizeof(v4sf) * vectors);
+    s->out = (v4sf *)pffft_aligned_malloc(sizeof(v4sf) * vectors);
+    memset(s->in, 0, sizeof(v4sf) * vectors);
+    memset(s->out, 0, sizeof(v4sf) * vectors);
+    s->kernel = kernel;
+    s->ido = ido;
+    s->l1 = l1;
+    for (i = 0; i < 4; i++) s->wa[i] = i < radix - 1 ? &wa[iw + i * ido] : NULL;
+
+    pass->state = s;
+    pass->stage = stage == FFTKernelStageFirst ? "first" : "last";
+    pass->calls = 1;
+    pass->stride = l1;
+    pass->butterflies = (long)length / (real ? 4 : radix);
+    pass->run = FFTKernelsPFFFTRun;
+    pass->release = FFTKernelsPFFFTRelease;
+    return 1;
+}
@@ -0,0 +1,72 @@
+//
+//  FFTKernelsShim.h
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#ifndef __FFTBench__FFTKernelsShim__
+#define __FFTBench__FFTKernelsShim__
+
+/*
+ C entry points to the static butterfly kernels of the vendored libraries.
+
+ Each FFTKernels<Lib>.c includes the library's own source, so the kernels are
+ the same code the library target is built from (CMakeLists.txt compiles the
+ shim in place of that source). A pass is every call of one kernel within one
+ stage of a real plan of the library: the same twiddles, strides and sizes a
+ transform of `length` runs it with.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    FFTKernelStageFirst = 0, ///< the first stage executed with this kernel (small sub-transforms)
+    FFTKernelStageLast,      ///< the last one (the widest butterflies, stride 1 twiddles)
+} FFTKernelStage;
+
+typedef struct FFTKernelPass {
+    void *state;
+    const char *stage;  ///< "first", "last", "leaf" or "all"
+    long calls;         ///< kernel calls per pass
+    long stride;        ///< twiddle / data stride the kernel is called with
+    long butterflies;   ///< scalar butterflies of its radix per pass, radix-2 ones for split radix
+    void (*run)(const struct FFTKernelPass *pass, long repeats);
+    void (*release)(struct FFTKernelPass *pass);
+} FFTKernelPass;
+
+
+enum { FFTKernelsKissRadixGeneric = 7 }; ///< kf_bfly_generic is timed as radix 7
+
+/// kf_bfly2/3/4/5 or kf_bfly_generic (radix 7), 0 if a kiss_fft plan of `length` has no such stage.
+int FFTKernelsKissPrepare(int radix, int length, FFTKernelStage stage, FFTKernelPass *pass);
+
+
+typedef enum {
+    FFTKernelsPFFFTPassf4 = 0,
+    FFTKernelsPFFFTPassf5,
+    FFTKernelsPFFFTRadf4,
+    FFTKernelsPFFFTRadb4,
+} FFTKernelsPFFFTKernel;
+
+/// passf4_ps/passf5_ps (complex setup) or radf4_ps/radb4_ps (real setup), 0 if not in the plan.
+int FFTKernelsPFFFTPrepare(int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass);
+
+
+typedef enum {
+    FFTKernelsNSFFTButForward16 = 0,
+    FFTKernelsNSFFTButForward32,
+    FFTKernelsNSFFTBitReversalCobra,
+} FFTKernelsNSFFTKernel;
+
+/// srButForward16/32 over the whole buffer, or bitReversalCobraInplace, in a SIMDBase mode built
+/// into the nsfft library; 0 if the mode is not available or `length` too short. First stage only.
+int FFTKernelsNSFFTPrepare(int mode, int kernel, int length, FFTKernelStage stage, FFTKernelPass *pass);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* defined(__FFTBench__FFTKernelsShim__) */
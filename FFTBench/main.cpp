@@ -0,0 +1,296 @@
+//
+//  main.cpp
+//  FFTBench
+//
+//  Copyright (c) 2014 ibireme. All rights reserved.
+//
+
+#include "FFTBench.h"
+#include "FFTBackend.h"
+#include "FFTThroughput.h"
+#include "FFTColdCache.h"
+#include "FFTLatency.h"
+#include "FFTSetup.h"
+#include "FFTBatch.h"
+#include "FFTAlignment.h"
+#include "FFTDenormal.h"
+#include "FFTKernels.h"
+#include "FFTStages.h"
+#include "FFTIsolate.h"
+#include "FFTPlanner.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void parseList(const char *value, std::vector<int> &list) {
+    list.clear();
+    for (const char *p = value; *p; ) {
+        list.push_back(atoi(p));
+        const char *comma = strchr(p, ',');
+        if (!comma) break;
+        p = comma + 1;
+    }
+}
+
+static void usage(const char *argv0) {
+    printf("usage: %s [options]\n"
+           "  -b, --backend NAME   run only this backend (repeatable), opt-in backends run only so\n"
+           "  --real               real-input (r2c/c2r) track instead of complex\n"
+           "  --double             double-precision track instead of single\n"
+           "  --min-log2 N         lengths start at 2^N (default 4)\n"
+           "  --max-log2 N         lengths end at 2^N (default 15, up to 24)\n"
+           "  --sizes SET          pow2 (default), 235, 7smooth or prime\n"
+           "  --lengths LIST       explicit lengths, e.g. 480,960,1536\n"
+           "  --points N           points per (backend, length, direction) (default 16777216)\n"
+           "  --trials N           timed trials per measurement (default 32)\n"
+           "  --warmup N           untimed iterations before the trials (default: one trial)\n"
+           "  --budget S           seconds per measurement instead of --points: repeats follow the\n"
+           "                       speed, trials drop to 3 for slower transforms (lengths past\n"
+           "                       points/trials use 1 s by default)\n"
+           "  --mem-limit MB       skip lengths and backends expected to need more (default: free RAM)\n"
+           "  --premarshal         skip fwd+load/inv+load, the transforms timed with their input reloaded\n"
+           "  --signal NAME        input: cosines (default), noise, impulse, decay (into subnormals),\n"
+           "                       tone, sparse\n"
+           "  --ftz                run with flush-to-zero/denormals-are-zero on\n"
+           "  --cycles             also report time stamp counter cycles (x86)\n"
+           "  --counters           hardware counters per transform: cycles, instructions, cache,\n"
+           "                       branch and dTLB misses (Linux perf_event_open)\n"
+           "  --energy             RAPL package and dram joules per million points of the bare fwd/inv\n"
+           "                       (Linux powercap, usually root only; whole socket, keep it idle)\n"
+           "  --roofline           measure peak GFLOPS and l1/cache/dram bandwidth, report each\n"
+           "                       forward transform in percent of its roofline bound\n"
+           "  --threads LIST       throughput mode with these thread counts, e.g. 1,2,4,8\n"
+           "  --shared-setup       threads share one plan where the library allows it\n"
+           "  --pin                pin thread i to cpu i (Linux)\n"
+           "  --seconds S          duration of one throughput measurement (default 0.5)\n"
+           "  --cold MB            hot versus cold caches: rotate through MB of independent setups\n"
+           "                       and inputs (0: twice the L2+L3 size) instead of the sweep\n"
+           "  --flush              with --cold, also time single calls after a cache flush\n"
+           "  --latency N          time N single fft+ifft pairs per cell (0: 100000), report tail\n"
+           "                       percentiles, allocations, page faults and stack use; lengths\n"
+           "                       default to 64..1024\n"
+           "  --setup              time setup/teardown and count the heap a plan keeps, per\n"
+           "                       backend (fftw-measure, nsfft-light/-heavy/-exh for planner levels)\n"
+           "  --batch B            B independent small forward transforms per pass (0: 4096), one\n"
+           "                       call each versus one per SIMD lane (nsfft, kiss-simd), per-call\n"
+           "                       overhead; lengths default to 16..256\n"
+           "  --alignment          forward time with buffers at 0..64 byte offsets and 4K-aliased\n"
+           "                       input/output, or the copy a library needs; lengths 256..16384\n"
+           "  --denormals          forward time per input signal with FTZ/DAZ off and on, the cost\n"
+           "                       of subnormal arithmetic; lengths 64..4096\n"
+           "  --kernels            ns and cycles per butterfly of the vendored radix kernels alone\n"
+           "                       (kiss, pffft, ckfft, nsfft, ne10); lengths 256..4096\n"
+           "  --stages             forward time per bit reversal, pass and recursion level inside\n"
+           "                       kiss, pffft, ckfft, nsfft (build with -DFFTBENCH_STAGE_TIMING=ON);\n"
+           "                       lengths 1024..1M\n"
+           "  --isolate R          run every backend/length cell of the sweep in a fresh process,\n"
+           "                       R rounds (0: 5) in random order, report the median over rounds\n"
+           "  --cpu N              core the --isolate children are pinned to (default: last of\n"
+           "                       isolcpus, else the last cpu); governor and turbo are checked\n"
+           "  --json PATH          write every measurement and the machine info as json\n"
+           "  --csv PATH           same as csv, one row per measurement\n"
+           "  --save-baseline DIR  store the measurements as DIR/<machine fingerprint>.csv\n"
+           "  --baseline DIR       compare against DIR/<machine fingerprint>.csv (or a .csv path),\n"
+           "                       exit 1 on a significant regression\n"
+           "  --threshold PCT      slowdown a regression needs besides disjoint ci95 (default 10)\n"
+           "  --wisdom PATH        where auto/auto-r/auto-d/auto-r-d keep the fastest backend per\n"
+           "                       length (default $FFTBENCH_WISDOM or ~/.fftbench-wisdom, \"\": none)\n"
+           "  -l, --list           list compiled-in backends and their track\n"
+           "  -h, --help           show this help\n", argv0);
+}
+
+int main(int argc, const char *argv[]) {
+    FFTBenchOptions options;
+    bool bounds = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+            usage(argv[0]);
+            return 0;
+        } else if (!strcmp(arg, "-l") || !strcmp(arg, "--list")) {
+            const std::vector<FFTBackendInfo> &all = FFTBackendRegistry::backends();
+            for (size_t b = 0; b < all.size(); b++) {
+                printf("%-14s %s %s%s\n", all[b].name, all[b].transform == FFTTransformReal ? "r2c" : "c2c",
+                       all[b].precision == FFTPrecisionDouble ? "double" : "float", all[b].optIn ? "  opt-in" : "");
+            }
+            return 0;
+        } else if ((!strcmp(arg, "-b") || !strcmp(arg, "--backend")) && value) {
+            options.backends.push_back(value);
+            i++;
+        } else if (!strcmp(arg, "--real")) {
+            options.transform = FFTTransformReal;
+        } else if (!strcmp(arg, "--double")) {
+            options.precision = FFTPrecisionDouble;
+        } else if (!strcmp(arg, "--min-log2") && value) {
+            options.minLog2 = atoi(value);
+            bounds = true;
+            i++;
+        } else if (!strcmp(arg, "--max-log2") && value) {
+            options.maxLog2 = atoi(value);
+            bounds = true;
+            i++;
+        } else if (!strcmp(arg, "--sizes") && value) {
+            if (!FFTSizeSetParse(value, &options.sizeSet)) {
+                fprintf(stderr, "unknown size set: %s\n", value);
+                return 1;
+            }
+            i++;
+        } else if (!strcmp(arg, "--lengths") && value) {
+            parseList(value, options.lengths);
+            i++;
+        } else if (!strcmp(arg, "--points") && value) {
+            options.points = atol(value);
+            i++;
+        } else if (!strcmp(arg, "--trials") && value) {
+            options.timer.trials = atoi(value);
+            i++;
+        } else if (!strcmp(arg, "--warmup") && value) {
+            options.timer.warmup = atol(value);
+            i++;
+        } else if (!strcmp(arg, "--budget") && value) {
+            options.timer.budget = atof(value);
+            i++;
+        } else if (!strcmp(arg, "--mem-limit") && value) {
+            options.memoryLimit = (size_t)(atof(value) * 1048576.0);
+            i++;
+        } else if (!strcmp(arg, "--premarshal")) {
+            options.premarshal = true;
+        } else if (!strcmp(arg, "--signal") && value) {
+            if (!FFTSignalParse(value, &options.signal)) {
+                fprintf(stderr, "unknown signal: %s\n", value);
+                return 1;
+            }
+            i++;
+        } else if (!strcmp(arg, "--ftz")) {
+            options.flushDenormals = true;
+        } else if (!strcmp(arg, "--cycles")) {
+            options.timer.cycles = true;
+        } else if (!strcmp(arg, "--counters")) {
+            options.counters = true;
+        } else if (!strcmp(arg, "--energy")) {
+            options.energy = true;
+        } else if (!strcmp(arg, "--roofline")) {
+            options.roofline = true;
+        } else if (!strcmp(arg, "--threads") && value) {
+            parseList(value, options.threads);
+            i++;
+        } else if (!strcmp(arg, "--shared-setup")) {
+            options.sharedSetup = true;
+        } else if (!strcmp(arg, "--pin")) {
+            options.pinThreads = true;
+        } else if (!strcmp(arg, "--seconds") && value) {
+            options.seconds = atof(value);
+            i++;
+        } else if (!strcmp(arg, "--cold") && value) {
+            options.cold = true;
+            options.coldPoolBytes = (size_t)(atof(value) * 1048576.0);
+            i++;
+        } else if (!strcmp(arg, "--flush")) {
+            options.flushCache = true;
+        } else if (!strcmp(arg, "--latency") && value) {
+            options.latency = true;
+            options.latencyCalls = atol(value);
+            i++;
+        } else if (!strcmp(arg, "--setup")) {
+            options.setupCost = true;
+        } else if (!strcmp(arg, "--batch") && value) {
+            options.batch = true;
+            options.batchTransforms = atol(value);
+            i++;
+        } else if (!strcmp(arg, "--alignment")) {
+            options.alignment = true;
+        } else if (!strcmp(arg, "--denormals")) {
+            options.denormals = true;
+        } else if (!strcmp(arg, "--kernels")) {
+            options.kernels = true;
+        } else if (!strcmp(arg, "--stages")) {
+            options.stages = true;
+        } else if (!strcmp(arg, "--isolate") && value) {
+            options.isolate = true;
+            options.isolateRounds = atoi(value);
+            i++;
+        } else if (!strcmp(arg, "--cpu") && value) {
+            options.isolateCpu = atoi(value);
+            i++;
+        } else if (!strcmp(arg, "--json") && value) {
+            options.jsonPath = value;
+            i++;
+        } else if (!strcmp(arg, "--csv") && value) {
+            options.csvPath = value;
+            i++;
+        } else if (!strcmp(arg, "--save-baseline") && value) {
+            options.saveBaselinePath = value;
+            i++;
+        } else if (!strcmp(arg, "--baseline") && value) {
+            options.baselinePath = value;
+            i++;
+        } else if (!strcmp(arg, "--threshold") && value) {
+            options.regressionThreshold = atof(value);
+            i++;
+        } else if (!strcmp(arg, "--wisdom") && value) {
+            FFTPlannerSetWisdomPath(value);
+            i++;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.minLog2 < 0 || options.maxLog2 > FFTBenchMaxLog2) {
+        fprintf(stderr, "lengths must lie within 2^0..2^%d\n", FFTBenchMaxLog2);
+        return 1;
+    }
+
+    if (options.setupCost) return FFTSetupRun(options) ? 1 : 0;
+    if (options.latency) {
+        if (!bounds) { // audio block sizes
+            options.minLog2 = 6;
+            options.maxLog2 = 10;
+        }
+        return FFTLatencyRun(options) ? 1 : 0;
+    }
+    if (options.batch) {
+        if (!bounds) { // small transforms
+            options.minLog2 = 4;
+            options.maxLog2 = 8;
+        }
+        return FFTBatchRun(options) ? 1 : 0;
+    }
+    if (options.alignment) {
+        if (!bounds) { // 2 KB to 128 KB of complex float: from L1 to past L2
+            options.minLog2 = 8;
+            options.maxLog2 = 14;
+        }
+        return FFTAlignmentRun(options) ? 1 : 0;
+    }
+    if (options.denormals) {
+        if (!bounds) { // subnormal cost is per flop, small lengths show it as well as large ones
+            options.minLog2 = 6;
+            options.maxLog2 = 12;
+        }
+        return FFTDenormalRun(options) ? 1 : 0;
+    }
+    if (options.kernels) {
+        if (!bounds) { // first and last stages differ from 256 points, both parities of log2 for radix 2 / 4
+            options.minLog2 = 8;
+            options.maxLog2 = 12;
+        }
+        return FFTKernelsRun(options) ? 1 : 0;
+    }
+    if (options.stages) {
+        if (!bounds) { // from in-cache lengths to ones where reordering leaves the caches
+            options.minLog2 = 10;
+            options.maxLog2 = 20;
+        }
+        return FFTStagesRun(options) ? 1 : 0;
+    }
+    if (options.isolate) return FFTIsolateRun(options, argc, argv) ? 1 : 0;
+    if (options.cold) return FFTColdCacheRun(options) ? 1 : 0;
+    if (!options.threads.empty()) return FFTThroughputRun(options) ? 1 : 0;
+    return FFTBenchRun(options) ? 1 : 0;
+}
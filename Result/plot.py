@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+#
+#  plot.py
+#  FFTBench
+#
+#  Copyright (c) 2014 ibireme. All rights reserved.
+#
+"""Draw the Result/ charts from an `FFTBench --json` file.
+
+    python3 Result/plot.py results.json -o charts
+
+One line chart of GFLOPS (5 N log2 N per complex transform, 2.5 N log2 N per
+real one) per fft length for every (precision, transform, direction) of the
+sweep, like fft-mbpr.png, one per cache state of a --cold run, one of p99.9
+latency per length of a --latency run, one of setup time per length of a
+--setup run, and one chart of Mfft/s per thread count for every length of a
+throughput run. A --roofline run also gets a roofline chart per (precision,
+transform): GFLOPS over flops per byte on log axes under the measured peak
+and bandwidth roofs. Files written before GFLOPS were recorded are drawn in
+M/s. The charts are SVG and need nothing beyond the Python standard library.
+"""
+
+import argparse
+import json
+import math
+import os
+import sys
+from xml.sax.saxutils import escape
+
+COLORS = ["#4a7ebb", "#be4b48", "#98b954", "#7d60a0", "#46aac5", "#f79646",
+          "#93a9cf", "#d19392", "#b9cd96", "#a99bbd", "#2c4d75", "#772c2a"]
+
+WIDTH, HEIGHT = 1000, 480
+LEFT, RIGHT, TOP, BOTTOM = 70, 230, 50, 50
+
+
+def nice_step(limit, ticks=6):
+    raw = limit / ticks
+    magnitude = 10 ** math.floor(math.log10(raw))
+    for factor in (1, 2, 2.5, 5, 10):
+        if raw <= factor * magnitude:
+            return factor * magnitude
+    return 10 * magnitude
+
+
+def line_chart(title, subtitle, unit, xlabel, categories, series):
+    """series: [(name, {category: value})], categories in display order"""
+    top = max([v for _, values in series for v in values.values()] + [1e-9])
+    step = nice_step(top)
+    ymax = step * math.ceil(top / step)
+    plot_w = WIDTH - LEFT - RIGHT
+    plot_h = HEIGHT - TOP - BOTTOM
+    dx = plot_w / max(len(categories), 1)
+
+    def x_of(i):
+        return LEFT + dx * (i + 0.5)
+
+    def y_of(v):
+        return TOP + plot_h * (1 - v / ymax)
+
+    out = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="Helvetica, Arial, sans-serif">'
+           % (WIDTH, HEIGHT),
+           '<rect width="100%" height="100%" fill="white"/>',
+           '<text x="%d" y="28" font-size="20" text-anchor="middle">%s <tspan font-size="14" fill="#555">%s</tspan></text>'
+           % (LEFT + plot_w / 2, escape(title), escape(subtitle)),
+           '<text x="%d" y="%d" font-size="13" text-anchor="end">%s</text>' % (LEFT - 8, TOP - 12, escape(unit))]
+
+    tick = 0.0
+    while tick <= ymax + step / 2:
+        y = y_of(tick)
+        out.append('<line x1="%d" y1="%.1f" x2="%d" y2="%.1f" stroke="#ccc"/>' % (LEFT, y, LEFT + plot_w, y))
+        out.append('<text x="%d" y="%.1f" font-size="13" text-anchor="end">%g</text>' % (LEFT - 8, y + 4, tick))
+        tick += step
+    for i, category in enumerate(categories):
+        out.append('<text x="%.1f" y="%d" font-size="13" text-anchor="middle">%s</text>'
+                   % (x_of(i), TOP + plot_h + 20, escape(str(category))))
+    out.append('<text x="%d" y="%d" font-size="13">%s</text>' % (LEFT + plot_w + 8, TOP + plot_h + 20, escape(xlabel)))
+
+    for s, (name, values) in enumerate(series):
+        color = COLORS[s % len(COLORS)]
+        points = [(x_of(i), y_of(values[c])) for i, c in enumerate(categories) if c in values]
+        if len(points) > 1:
+            out.append('<polyline fill="none" stroke="%s" stroke-width="2.5" points="%s"/>'
+                       % (color, " ".join("%.1f,%.1f" % p for p in points)))
+        for x, y in points:
+            out.append('<circle cx="%.1f" cy="%.1f" r="4" fill="%s"/>' % (x, y, color))
+        ly = TOP + 10 + s * 24
+        out.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="%s" stroke-width="2.5"/>'
+                   % (LEFT + plot_w + 20, ly, LEFT + plot_w + 50, ly, color))
+        out.append('<text x="%d" y="%d" font-size="14">%s</text>' % (LEFT + plot_w + 58, ly + 5, escape(name)))
+
+    out.append("</svg>")
+    return "\n".join(out) + "\n"
+
+
+def log_ticks(low, high):
+    """powers of ten covering [low, high]"""
+    first = math.floor(math.log10(low))
+    last = math.ceil(math.log10(high))
+    return [10.0 ** e for e in range(first, last + 1)]
+
+
+def roofline_chart(title, subtitle, roofline, series):
+    """series: [(name, [(flops per byte, gflops, length)])] on log axes under the roofs"""
+    peak = roofline["gflops"]
+    roofs = [(level, roofline[level + "_gb_s"]) for level in ("l1", "cache", "dram")]
+    xs = [x for _, points in series for x, _, _ in points] + [peak / bw for _, bw in roofs]
+    ys = [y for _, points in series for _, y, _ in points] + [peak]
+    xlow, xhigh = log_ticks(min(xs) / 2, max(xs) * 2)[0], log_ticks(min(xs) / 2, max(xs) * 2)[-1]
+    ylow, yhigh = log_ticks(min(ys) / 2, peak * 2)[0], log_ticks(min(ys) / 2, peak * 2)[-1]
+    plot_w = WIDTH - LEFT - RIGHT
+    plot_h = HEIGHT - TOP - BOTTOM
+
+    def x_of(v):
+        return LEFT + plot_w * math.log10(v / xlow) / math.log10(xhigh / xlow)
+
+    def y_of(v):
+        return TOP + plot_h * (1 - math.log10(v / ylow) / math.log10(yhigh / ylow))
+
+    out = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="Helvetica, Arial, sans-serif">'
+           % (WIDTH, HEIGHT),
+           '<rect width="100%" height="100%" fill="white"/>',
+           '<text x="%d" y="28" font-size="20" text-anchor="middle">%s <tspan font-size="14" fill="#555">%s</tspan></text>'
+           % (LEFT + plot_w / 2, escape(title), escape(subtitle)),
+           '<text x="%d" y="%d" font-size="13" text-anchor="end">GFLOPS</text>' % (LEFT - 8, TOP - 12)]
+    for tick in log_ticks(ylow, yhigh):
+        y = y_of(tick)
+        out.append('<line x1="%d" y1="%.1f" x2="%d" y2="%.1f" stroke="#ccc"/>' % (LEFT, y, LEFT + plot_w, y))
+        out.append('<text x="%d" y="%.1f" font-size="13" text-anchor="end">%g</text>' % (LEFT - 8, y + 4, tick))
+    for tick in log_ticks(xlow, xhigh):
+        x = x_of(tick)
+        out.append('<line x1="%.1f" y1="%d" x2="%.1f" y2="%d" stroke="#eee"/>' % (x, TOP, x, TOP + plot_h))
+        out.append('<text x="%.1f" y="%d" font-size="13" text-anchor="middle">%g</text>' % (x, TOP + plot_h + 20, tick))
+    out.append('<text x="%d" y="%d" font-size="13">flops/byte</text>' % (LEFT + plot_w + 8, TOP + plot_h + 20))
+
+    # roofs: bandwidth slopes up to the ridge, then the flat peak
+    for level, bandwidth in roofs:
+        ridge = peak / bandwidth
+        start = max(xlow, ylow / bandwidth)
+        if ridge > start:
+            out.append('<line x1="%.1f" y1="%.1f" x2="%.1f" y2="%.1f" stroke="#888" stroke-dasharray="5,3"/>'
+                       % (x_of(start), y_of(start * bandwidth), x_of(ridge), y_of(peak)))
+        label_x = min(max(start * 2, xlow * 1.5), ridge)
+        out.append('<text x="%.1f" y="%.1f" font-size="12" fill="#666">%s %.0f GB/s</text>'
+                   % (x_of(label_x) + 4, y_of(label_x * bandwidth) - 6, level, bandwidth))
+    out.append('<line x1="%.1f" y1="%.1f" x2="%.1f" y2="%.1f" stroke="#888"/>'
+               % (x_of(min(peak / bw for _, bw in roofs)), y_of(peak), x_of(xhigh), y_of(peak)))
+    out.append('<text x="%.1f" y="%.1f" font-size="12" fill="#666" text-anchor="end">peak %.0f GFLOPS (%s)</text>'
+               % (x_of(xhigh) - 4, y_of(peak) - 6, peak, roofline.get("isa", "")))
+
+    for s, (name, points) in enumerate(series):
+        color = COLORS[s % len(COLORS)]
+        coords = [(x_of(x), y_of(y)) for x, y, _ in sorted(points, key=lambda p: p[2])]
+        if len(coords) > 1:
+            out.append('<polyline fill="none" stroke="%s" stroke-width="1.5" points="%s"/>'
+                       % (color, " ".join("%.1f,%.1f" % p for p in coords)))
+        for x, y in coords:
+            out.append('<circle cx="%.1f" cy="%.1f" r="4" fill="%s"/>' % (x, y, color))
+        ly = TOP + 10 + s * 24
+        out.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="%s" stroke-width="2.5"/>'
+                   % (LEFT + plot_w + 20, ly, LEFT + plot_w + 50, ly, color))
+        out.append('<text x="%d" y="%d" font-size="14">%s</text>' % (LEFT + plot_w + 58, ly + 5, escape(name)))
+
+    out.append("</svg>")
+    return "\n".join(out) + "\n"
+
+
+def rate(record):
+    """GFLOPS, or M/s for files written before GFLOPS were recorded"""
+    return record["gflops"] if "gflops" in record else record["mpoints_per_s"]
+
+
+def write(path, text):
+    with open(path, "w") as f:
+        f.write(text)
+    print(path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("json", help="output of FFTBench --json")
+    parser.add_argument("-o", "--output", default=".", help="directory of the charts (default: .)")
+    args = parser.parse_args()
+
+    with open(args.json) as f:
+        data = json.load(f)
+    machine = data.get("machine", {})
+    title = machine.get("processor") or "FFTBench"
+    arch = machine.get("arch", "")
+    records = [r for r in data.get("records", []) if r.get("status") == "ok"]
+    os.makedirs(args.output, exist_ok=True)
+
+    unit = "GFLOPS" if any("gflops" in r for r in records) else "M/s"
+
+    # sweep: GFLOPS per length, one chart per precision/transform/direction
+    groups = {}
+    sweep = [r for r in records if r["threads"] == 1 and "mpoints_per_s" in r and r["direction"] in ("fwd", "inv")
+             and "cache" not in r and "placement" not in r and "signal" not in r and "transforms" not in r]
+    for r in sweep:
+        key = (r["precision"], r["transform"], r["direction"])
+        groups.setdefault(key, {}).setdefault(r["backend"], {})[r["length"]] = rate(r)
+    for (precision, transform, direction), backends in sorted(groups.items()):
+        lengths = sorted({n for values in backends.values() for n in values})
+        series = sorted(backends.items(), key=lambda item: -max(item[1].values()))
+        svg = line_chart(title, "%s  %s %s %s" % (arch, precision, transform, direction), unit, "fft length",
+                         lengths, series)
+        write(os.path.join(args.output, "fft-%s-%s-%s.svg" % (precision, transform, direction)), svg)
+
+    # roofline: forward GFLOPS over nominal flops per byte, one chart per precision/transform
+    roofline = data.get("roofline")
+    groups = {}
+    for r in sweep:
+        if roofline and r["direction"] == "fwd" and "gflops" in r and r["precision"] == roofline["precision"]:
+            key = (r["precision"], r["transform"])
+            groups.setdefault(key, {}).setdefault(r["backend"], []).append(
+                (r["flops"] / r["bytes"], r["gflops"], r["length"]))
+    for (precision, transform), backends in sorted(groups.items()):
+        series = sorted(backends.items(), key=lambda item: -max(g for _, g, _ in item[1]))
+        svg = roofline_chart(title, "%s  %s %s fwd, %d to %d points" % (
+            arch, precision, transform, min(n for _, points in series for _, _, n in points),
+            max(n for _, points in series for _, _, n in points)), roofline, series)
+        write(os.path.join(args.output, "roofline-%s-%s.svg" % (precision, transform)), svg)
+
+    # cold cache: GFLOPS per length, one chart per precision/transform/cache state
+    groups = {}
+    for r in records:
+        if "cache" in r and "mpoints_per_s" in r:
+            key = (r["precision"], r["transform"], r["cache"])
+            groups.setdefault(key, {}).setdefault(r["backend"], {})[r["length"]] = rate(r)
+    for (precision, transform, cache), backends in sorted(groups.items()):
+        lengths = sorted({n for values in backends.values() for n in values})
+        series = sorted(backends.items(), key=lambda item: -max(item[1].values()))
+        svg = line_chart(title, "%s  %s %s roundtrip, %s cache" % (arch, precision, transform, cache), unit,
+                         "fft length", lengths, series)
+        write(os.path.join(args.output, "cache-%s-%s-%s.svg" % (precision, transform, cache)), svg)
+
+    # latency: p99.9 of single fft+ifft pairs per length
+    groups = {}
+    for r in records:
+        if "histogram_ns" in r and "ns" in r:
+            key = (r["precision"], r["transform"])
+            groups.setdefault(key, {}).setdefault(r["backend"], {})[r["length"]] = r["ns"]["p999"] * 1e-3
+    for (precision, transform), backends in sorted(groups.items()):
+        lengths = sorted({n for values in backends.values() for n in values})
+        series = sorted(backends.items(), key=lambda item: max(item[1].values()))
+        svg = line_chart(title, "%s  %s %s fft+ifft p99.9" % (arch, precision, transform), "us", "fft length",
+                         lengths, series)
+        write(os.path.join(args.output, "latency-%s-%s.svg" % (precision, transform)), svg)
+
+    # setup: median setup time per length
+    groups = {}
+    for r in records:
+        if r["direction"] == "setup" and "ns" in r:
+            key = (r["precision"], r["transform"])
+            groups.setdefault(key, {}).setdefault(r["backend"], {})[r["length"]] = r["ns"]["median"] * 1e-3
+    for (precision, transform), backends in sorted(groups.items()):
+        lengths = sorted({n for values in backends.values() for n in values})
+        series = sorted(backends.items(), key=lambda item: max(item[1].values()))
+        svg = line_chart(title, "%s  %s %s setup" % (arch, precision, transform), "us", "fft length", lengths, series)
+        write(os.path.join(args.output, "setup-%s-%s.svg" % (precision, transform)), svg)
+
+    # throughput: Mfft/s per thread count, one chart per length
+    groups = {}
+    for r in records:
+        if r["direction"] == "roundtrip" and "mfft_per_s" in r:
+            key = (r["precision"], r["transform"], r["length"])
+            groups.setdefault(key, {}).setdefault(r["backend"], {})[r["threads"]] = r["mfft_per_s"]
+    for (precision, transform, length), backends in sorted(groups.items()):
+        threads = sorted({t for values in backends.values() for t in values})
+        series = sorted(backends.items(), key=lambda item: -max(item[1].values()))
+        svg = line_chart(title, "%s  %s %s, %d points" % (arch, precision, transform, length), "Mfft/s", "threads",
+                         threads, series)
+        write(os.path.join(args.output, "throughput-%s-%s-%d.svg" % (precision, transform, length)), svg)
+
+    if not data.get("records"):
+        print("no records in %s" % args.json, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -5,6 +5,13 @@
 #include "math_util.h"
 #include <assert.h>
 
+#ifdef FFTBENCH_STAGE_TIMING
+#include "FFTStageHooks.h"
+#else
+#define FFT_STAGE_BEGIN(name)
+#define FFT_STAGE_END(name, stage, level)
+#endif
+
 namespace ckfft
 {
 
@@ -21,6 +28,7 @@ void fft_default(
 {
     if (count == 4)
     {
+        FFT_STAGE_BEGIN(leaf);
         // radix-4 recursion step for count == 4
 
         // this code will be called at the deepest recursion level for FFT sizes
@@ -64,9 +72,11 @@ void fft_default(
             out3->real = diff02.real - diff13.imag;
             out3->imag = diff02.imag + diff13.real;
         }
+        FFT_STAGE_END(leaf, FFTStageCkFFTLeaves, 2);
     }
     else if (count == 8)
     {
+        FFT_STAGE_BEGIN(leaf);
         // radix-4 recursion step for count == 8, with loop unrolled
 
         // this code will be called at the deepest recursion level for FFT sizes
@@ -164,6 +174,7 @@ void fft_default(
             out3->real = diff02.real - diff13.imag;
             out3->imag = diff02.imag + diff13.real;
         }
+        FFT_STAGE_END(leaf, FFTStageCkFFTLeaves, 3);
     }
     else
     {
@@ -184,6 +195,8 @@ void fft_default(
             out += n;
         }
 
+        FFT_STAGE_BEGIN(combine);
+
         const CkFftComplex* exp1 = expTable;
         const CkFftComplex* exp2 = exp1;
         const CkFftComplex* exp3 = exp1;
@@ -264,6 +277,7 @@ void fft_default(
             ++out2;
             ++out3;
         }
+        FFT_STAGE_END(combine, FFTStageCkFFTButterflies, FFTStageLog2(count));
         /*
         else
         {
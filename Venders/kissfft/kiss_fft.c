@@ -18,6 +18,13 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
  fixed or floating point complex numbers.  It also delares the kf_ internal functions.
  */
 
+#ifdef FFTBENCH_STAGE_TIMING
+#include "FFTStageHooks.h"
+#else
+#define FFT_STAGE_BEGIN(name)
+#define FFT_STAGE_END(name, stage, level)
+#endif
+
 static void kf_bfly2(
         kiss_fft_cpx * Fout,
         const size_t fstride,
@@ -274,10 +281,12 @@ void kf_work(
 #endif
 
     if (m==1) {
+        FFT_STAGE_BEGIN(gather);
         do{
             *Fout = *f;
             f += fstride*in_stride;
         }while(++Fout != Fout_end );
+        FFT_STAGE_END(gather, FFTStageKissGather, (int)(factors - st->factors) / 2 - 1);
     }else{
         do{
             // recursive call:
@@ -292,6 +301,7 @@ void kf_work(
     Fout=Fout_beg;
 
     // recombine the p smaller DFTs 
+    FFT_STAGE_BEGIN(bfly);
     switch (p) {
         case 2: kf_bfly2(Fout,fstride,st,m); break;
         case 3: kf_bfly3(Fout,fstride,st,m); break; 
@@ -299,6 +309,7 @@ void kf_work(
         case 5: kf_bfly5(Fout,fstride,st,m); break; 
         default: kf_bfly_generic(Fout,fstride,st,m,p); break;
     }
+    FFT_STAGE_END(bfly, FFTStageKissButterflies, (int)(factors - st->factors) / 2 - 1);
 }
 
 /*  facbuf is populated by p1,m1,p2,m2, ...
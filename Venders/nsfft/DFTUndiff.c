@@ -8,6 +8,13 @@
 #include "DFT.h"
 #include "DFTUndiff.h"
 
+#ifdef FFTBENCH_STAGE_TIMING
+#include "FFTStageHooks.h"
+#else
+#define FFT_STAGE_BEGIN(name)
+#define FFT_STAGE_END(name, stage, level)
+#endif
+
 //
 
 #define SIN(x) sin(x)
@@ -1455,41 +1462,57 @@ void DFTUndiff_EXECUTE(void *p2, void *s2, int32_t dir) {
 
   if (dir == -1) {
     if ((p->flags & DFT_FLAG_ALT_REAL) != 0) {
+      FFT_STAGE_BEGIN(real);
       realSub1(p, s, 0);
+      FFT_STAGE_END(real, FFTStageNSFFTReal, 0);
     }
 
+    FFT_STAGE_BEGIN(butterflies);
     srForwardMain(p);
+    FFT_STAGE_END(butterflies, FFTStageNSFFTButterflies, 0);
 
     if ((p->flags & DFT_FLAG_NO_BITREVERSAL) == 0) {
+      FFT_STAGE_BEGIN(reversal);
       if (p->useCobra) {
 	bitReversalCobraInplace(p);
       } else {
 	bitReversalRecursive(p->s, p->length, 1, 0, 0);
       }
+      FFT_STAGE_END(reversal, FFTStageNSFFTBitReversal, 0);
     }
 
     if ((p->flags & DFT_FLAG_REAL) != 0) {
+      FFT_STAGE_BEGIN(real);
       realSub0(p, s, 0);
       s[p->length+1] = SIMDBase_NEGi(s[p->length+1]);
+      FFT_STAGE_END(real, FFTStageNSFFTReal, 0);
     }
   } else {
     if ((p->flags & DFT_FLAG_REAL) != 0) {
+      FFT_STAGE_BEGIN(real);
       s[p->length+1] = SIMDBase_NEGi(s[p->length+1]);
       realSub1(p, s, 1);
+      FFT_STAGE_END(real, FFTStageNSFFTReal, 0);
     }
 
     if ((p->flags & DFT_FLAG_NO_BITREVERSAL) == 0) {
+      FFT_STAGE_BEGIN(reversal);
       if (p->useCobra) {
 	bitReversalCobraInplace(p);
       } else {
 	bitReversalRecursive(p->s, p->length, 1, 0, 0);
       }
+      FFT_STAGE_END(reversal, FFTStageNSFFTBitReversal, 0);
     }
 
+    FFT_STAGE_BEGIN(butterflies);
     srBackwardMain(p);
+    FFT_STAGE_END(butterflies, FFTStageNSFFTButterflies, 0);
 
     if ((p->flags & DFT_FLAG_ALT_REAL) != 0) {
+      FFT_STAGE_BEGIN(real);
       realSub0(p, s, 1);
+      FFT_STAGE_END(real, FFTStageNSFFTReal, 0);
     }
   }
 }
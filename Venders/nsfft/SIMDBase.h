@@ -6,10 +6,12 @@ extern "C" {
 #endif
     
     ///
+#ifndef NSFFT_BUILD_MODES /* else the build passes -DENABLE_<MODE> per file */
 #ifdef __ARM_NEON__
 #define ENABLE_NEON_FLOAT
 #else
 #define ENABLE_PUREC_FLOAT
+#endif
 #endif
     ///
     
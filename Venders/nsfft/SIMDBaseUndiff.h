@@ -2,11 +2,13 @@
 #define _SIMDBaseUndiff_H_
 
 ///
+#ifndef NSFFT_BUILD_MODES /* else the build passes -DENABLE_<MODE> per file */
 #ifdef __ARM_NEON__
 #define ENABLE_NEON_FLOAT
 #else
 #define ENABLE_PUREC_FLOAT
 #endif
+#endif
 ///
 
 #if defined(ENABLE_PUREC_FLOAT) ////////////////////////////////////////////
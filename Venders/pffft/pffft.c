@@ -63,6 +63,13 @@
 #include <math.h>
 #include <assert.h>
 
+#ifdef FFTBENCH_STAGE_TIMING
+#include "FFTStageHooks.h"
+#else
+#define FFT_STAGE_BEGIN(name)
+#define FFT_STAGE_END(name, stage, level)
+#endif
+
 /* detect compiler flavour */
 #if defined(_MSC_VER)
 #  define COMPILER_MSVC
@@ -968,6 +975,7 @@ static NEVER_INLINE(v4sf *) rfftf1_ps(int n, const v4sf *input_readonly, v4sf *w
     int l1 = l2 / ip;
     int ido = n / l2;
     iw -= (ip - 1)*ido;
+    FFT_STAGE_BEGIN(pass);
     switch (ip) {
       case 5: {
         int ix2 = iw + ido;
@@ -991,6 +999,7 @@ static NEVER_INLINE(v4sf *) rfftf1_ps(int n, const v4sf *input_readonly, v4sf *w
         assert(0);
         break;
     }
+    FFT_STAGE_END(pass, FFTStagePFFFTPass, k1 - 1);
     l2 = l1;
     if (out == work2) {
       out = work1; in = work2;
@@ -1013,6 +1022,7 @@ static NEVER_INLINE(v4sf *) rfftb1_ps(int n, const v4sf *input_readonly, v4sf *w
     int ip = ifac[k1 + 1];
     int l2 = ip*l1;
     int ido = n / l2;
+    FFT_STAGE_BEGIN(pass);
     switch (ip) {
       case 5: {
         int ix2 = iw + ido;
@@ -1036,6 +1046,7 @@ static NEVER_INLINE(v4sf *) rfftb1_ps(int n, const v4sf *input_readonly, v4sf *w
         assert(0);
         break;
     }
+    FFT_STAGE_END(pass, FFTStagePFFFTPass, k1 - 1);
     l1 = l2;
     iw += (ip - 1)*ido;
 
@@ -1159,6 +1170,7 @@ v4sf *cfftf1_ps(int n, const v4sf *input_readonly, v4sf *work1, v4sf *work2, con
     int l2 = ip*l1;
     int ido = n / l2;
     int idot = ido + ido;
+    FFT_STAGE_BEGIN(pass);
     switch (ip) {
       case 5: {
         int ix2 = iw + idot;
@@ -1181,6 +1193,7 @@ v4sf *cfftf1_ps(int n, const v4sf *input_readonly, v4sf *work1, v4sf *work2, con
       default:
         assert(0);
     }
+    FFT_STAGE_END(pass, FFTStagePFFFTPass, k1 - 2);
     l1 = l2;
     iw += (ip - 1)*idot;
     if (out == work2) {
@@ -1300,6 +1313,7 @@ void pffft_zreorder(PFFFT_Setup *setup, const float *in, float *out, pffft_direc
   int k, N = setup->N, Ncvec = setup->Ncvec;
   const v4sf *vin = (const v4sf*)in;
   v4sf *vout = (v4sf*)out;
+  FFT_STAGE_BEGIN(reorder);
   assert(in != out);
   if (setup->transform == PFFFT_REAL) {
     int k, dk = N/32;
@@ -1331,6 +1345,7 @@ void pffft_zreorder(PFFFT_Setup *setup, const float *in, float *out, pffft_direc
       }
     }
   }
+  FFT_STAGE_END(reorder, FFTStagePFFFTReorder, 0);
 }
 
 void pffft_cplx_finalize(int Ncvec, const v4sf *in, v4sf *out, const v4sf *e) {
@@ -1625,15 +1640,21 @@ void pffft_transform_internal(PFFFT_Setup *setup, const float *finput, float *fo
     if (setup->transform == PFFFT_REAL) { 
       ib = (rfftf1_ps(Ncvec*2, vinput, buff[ib], buff[!ib],
                       setup->twiddle, &setup->ifac[0]) == buff[0] ? 0 : 1);      
+      FFT_STAGE_BEGIN(finalize);
       pffft_real_finalize(Ncvec, buff[ib], buff[!ib], (v4sf*)setup->e);
+      FFT_STAGE_END(finalize, FFTStagePFFFTFinalize, 0);
     } else {
       v4sf *tmp = buff[ib];
+      FFT_STAGE_BEGIN(uninterleave);
       for (k=0; k < Ncvec; ++k) {
         UNINTERLEAVE2(vinput[k*2], vinput[k*2+1], tmp[k*2], tmp[k*2+1]);
       }
+      FFT_STAGE_END(uninterleave, FFTStagePFFFTFinalize, 0);
       ib = (cfftf1_ps(Ncvec, buff[ib], buff[!ib], buff[ib], 
                       setup->twiddle, &setup->ifac[0], -1) == buff[0] ? 0 : 1);
+      FFT_STAGE_BEGIN(finalize);
       pffft_cplx_finalize(Ncvec, buff[ib], buff[!ib], (v4sf*)setup->e);
+      FFT_STAGE_END(finalize, FFTStagePFFFTFinalize, 0);
     }
     if (ordered) {
       pffft_zreorder(setup, (float*)buff[!ib], (float*)buff[ib], PFFFT_FORWARD);       
@@ -1647,16 +1668,22 @@ void pffft_transform_internal(PFFFT_Setup *setup, const float *finput, float *fo
       vinput = buff[ib]; ib = !ib;
     }
     if (setup->transform == PFFFT_REAL) {
+      FFT_STAGE_BEGIN(preprocess);
       pffft_real_preprocess(Ncvec, vinput, buff[ib], (v4sf*)setup->e);
+      FFT_STAGE_END(preprocess, FFTStagePFFFTFinalize, 0);
       ib = (rfftb1_ps(Ncvec*2, buff[ib], buff[0], buff[1], 
                       setup->twiddle, &setup->ifac[0]) == buff[0] ? 0 : 1);
     } else {
+      FFT_STAGE_BEGIN(preprocess);
       pffft_cplx_preprocess(Ncvec, vinput, buff[ib], (v4sf*)setup->e);
+      FFT_STAGE_END(preprocess, FFTStagePFFFTFinalize, 0);
       ib = (cfftf1_ps(Ncvec, buff[ib], buff[0], buff[1], 
                       setup->twiddle, &setup->ifac[0], +1) == buff[0] ? 0 : 1);
+      FFT_STAGE_BEGIN(interleave);
       for (k=0; k < Ncvec; ++k) {
         INTERLEAVE2(buff[ib][k*2], buff[ib][k*2+1], buff[ib][k*2], buff[ib][k*2+1]);
       }
+      FFT_STAGE_END(interleave, FFTStagePFFFTFinalize, 0);
     }
   }
   
@@ -1775,8 +1802,10 @@ void pffft_zconvolve_accumulate(PFFFT_Setup *s, const float *a, const float *b,
 #define pffft_zreorder_nosimd pffft_zreorder
 void pffft_zreorder_nosimd(PFFFT_Setup *setup, const float *in, float *out, pffft_direction_t direction) {
   int k, N = setup->N;
+  FFT_STAGE_BEGIN(reorder);
   if (setup->transform == PFFFT_COMPLEX) {
     for (k=0; k < 2*N; ++k) out[k] = in[k];
+    FFT_STAGE_END(reorder, FFTStagePFFFTReorder, 0);
     return;
   }
   else if (direction == PFFFT_FORWARD) {
@@ -1790,6 +1819,7 @@ void pffft_zreorder_nosimd(PFFFT_Setup *setup, const float *in, float *out, pfff
     out[0] = in[0];
     out[N-1] = x_N;
   }
+  FFT_STAGE_END(reorder, FFTStagePFFFTReorder, 0);
 }
 
 #define pffft_transform_internal_nosimd pffft_transform_internal